@@ -4,12 +4,15 @@
 
 #include "Game/Game.hpp"
 #include "Game/Behavior.hpp"
+#include "Game/FieldOfView.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Inventory.hpp"
 #include "Game/Item.hpp"
+#include "Game/Layer.hpp"
 #include "Game/Map.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <format>
 #include <numeric>
@@ -45,6 +48,7 @@ Actor::Actor(Map* map, EntityDefinition* definition) noexcept
 {
     this->map = map;
     this->layer = this->map->GetLayer(0);
+    _definition = definition;
     sprite = definition->GetSprite();
     OnDamage.Subscribe_method(this, &Actor::ApplyDamage);
     OnFight.Subscribe_method(this, &Actor::ResolveAttack);
@@ -83,6 +87,7 @@ bool Actor::LoadFromXml(const XMLElement& elem) {
     name = DataUtils::ParseXmlAttribute(elem, "name", name);
     const auto definitionName = DataUtils::ParseXmlAttribute(elem, "lookAndFeel", std::string{});
     auto* def = EntityDefinition::GetEntityDefinitionByName(definitionName);
+    _definition = def;
     sprite = def->GetSprite();
     inventory = def->inventory;
     const auto behaviorName = DataUtils::ParseXmlAttribute(elem, "behavior", std::string{"none"});
@@ -344,12 +349,81 @@ void Actor::SetPosition(const IntVector2& position) {
             }
         }
     }
+    DirtyFieldOfView();
+}
+
+float Actor::GetSightRadius() const noexcept {
+    if(_definition) {
+        return _definition->sight_radius;
+    }
+    return default_actor_sight_radius;
+}
+
+FieldOfViewMode Actor::GetFieldOfViewMode() const noexcept {
+    if(_definition) {
+        return _definition->fov_mode;
+    }
+    return FieldOfViewMode::Shadowcast;
+}
+
+bool Actor::CanSee(const IntVector2& tile_coords) const noexcept {
+    if(_field_of_view_dirty) {
+        UpdateFieldOfView();
+    }
+    return _field_of_view.Test(tile_coords - _field_of_view_mins);
+}
+
+//Sight between actors is mutual: each must be in the other's field of view, so the smaller
+//radius wins and "I see you" implies "you see me" even when their modes differ.
+bool Actor::CanSee(const Entity& target) const noexcept {
+    if(target.layer != layer || !CanSee(target.GetPosition())) {
+        return false;
+    }
+    if(const auto* other = dynamic_cast<const Actor*>(&target); other != nullptr) {
+        return other->CanSee(GetPosition());
+    }
+    return true;
+}
+
+void Actor::DirtyFieldOfView() noexcept {
+    _field_of_view_dirty = true;
+}
+
+//Only opacity changes inside the cached window can change what this actor sees.
+void Actor::OnOpacityChanged(const IntVector2& tile_coords) noexcept {
+    if(_field_of_view_dirty) {
+        return;
+    }
+    const auto& dimensions = _field_of_view.GetDimensions();
+    const auto local = tile_coords - _field_of_view_mins;
+    if(local.x >= 0 && local.y >= 0 && local.x < dimensions.x && local.y < dimensions.y) {
+        DirtyFieldOfView();
+    }
+}
+
+void Actor::UpdateFieldOfView() const noexcept {
+    _field_of_view_dirty = false;
+    const auto radius = GetSightRadius();
+    const auto extent = static_cast<int>(std::ceil(radius));
+    const auto dimensions = IntVector2{2 * extent + 1, 2 * extent + 1};
+    if(_field_of_view.GetDimensions() != dimensions) {
+        _field_of_view.Resize(dimensions);
+    } else {
+        _field_of_view.Clear();
+    }
+    _field_of_view_mins = _position - IntVector2{extent, extent};
+    if(layer == nullptr) {
+        return;
+    }
+    const auto is_opaque = [this](const IntVector2& coords) { return layer->IsTileOpaque(coords); };
+    const auto mark_visible = [this](const IntVector2& coords) { _field_of_view.Set(coords - _field_of_view_mins); };
+    FieldOfView::Calculate(GetFieldOfViewMode(), _position, radius, layer->tileDimensions, is_opaque, mark_visible);
 }
 
 void Actor::SetBehavior(BehaviorID id) {
     const auto behaviorName = Behavior::NameFromId(id);
-    if(auto* def = EntityDefinition::GetEntityDefinitionByName(name)) {
-        const auto& behaviors = def->GetAvailableBehaviors();
+    if(_definition) {
+        const auto& behaviors = _definition->GetAvailableBehaviors();
         const auto found_iter = std::find_if(std::begin(behaviors), std::end(behaviors), [this, &behaviorName](auto b) { return b->GetName() == behaviorName; });
         const auto is_available = found_iter != std::end(behaviors);
         if(is_available) {
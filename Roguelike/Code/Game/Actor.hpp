@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Game/Behavior.hpp"
+#include "Game/BitGrid.hpp"
 #include "Game/Entity.hpp"
+#include "Game/FieldOfView.hpp"
 #include "Game/Item.hpp"
 
 #include <map>
@@ -57,6 +59,13 @@ public:
 
     void CalculateLightValue() noexcept override;
 
+    float GetSightRadius() const noexcept;
+    FieldOfViewMode GetFieldOfViewMode() const noexcept;
+    bool CanSee(const IntVector2& tile_coords) const noexcept;
+    bool CanSee(const Entity& target) const noexcept;
+    void DirtyFieldOfView() noexcept;
+    void OnOpacityChanged(const IntVector2& tile_coords) noexcept;
+
 protected:
 
 private:
@@ -67,6 +76,7 @@ private:
     void AttackerMissed();
 
     bool CanMoveDiagonallyToNeighbor(const IntVector2& direction) const;
+    void UpdateFieldOfView() const noexcept;
 
     std::vector<Item*> GetAllEquipmentOfType(const EquipSlot& slot) const;
     std::vector<Item*> GetAllCapeEquipment() const;
@@ -80,6 +90,10 @@ private:
 
     static std::multimap<std::string, std::unique_ptr<Actor>> s_registry;
     std::vector<Item*> _equipment = std::vector<Item*>(static_cast<std::size_t>(EquipSlot::Max));
+    EntityDefinition* _definition{};
     Behavior* _active_behavior{};
+    mutable BitGrid _field_of_view{};
+    mutable IntVector2 _field_of_view_mins{};
+    mutable bool _field_of_view_dirty = true;
     bool _acted = false;
 };
@@ -21,6 +21,13 @@ std::vector<Map>::iterator Adventure::CurrentMap() const noexcept {
     return _current_map_iter;
 }
 
+Map* Adventure::CurrentMapOrNull() const noexcept {
+    if(_maps.empty() || _current_map_iter == std::end(_maps)) {
+        return nullptr;
+    }
+    return &*_current_map_iter;
+}
+
 void Adventure::NextMap() noexcept {
     if(_current_map_iter != std::end(_maps) - 1) {
         ++_current_map_iter;
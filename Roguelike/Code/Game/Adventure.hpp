@@ -24,6 +24,7 @@ public:
     Actor* player{};
 
     std::vector<Map>::iterator CurrentMap() const noexcept;
+    Map* CurrentMapOrNull() const noexcept;
     void NextMap() noexcept;
     void PreviousMap() noexcept;
 
@@ -0,0 +1,106 @@
+#include "Game/AnimationScheduler.hpp"
+
+#include "Engine/Renderer/AnimatedSprite.hpp"
+
+#include "Game/EntityDefinition.hpp"
+#include "Game/Item.hpp"
+#include "Game/TileDefinition.hpp"
+
+#include <algorithm>
+
+void AnimationScheduler::Track(AnimatedSprite* sprite) noexcept {
+    if(sprite) {
+        _sprites.push_back(sprite);
+    }
+}
+
+//Features draw with tile definition sprites, so these three registries cover everything on a map.
+void AnimationScheduler::TrackDefinitionSprites() noexcept {
+    for(auto* def : TileDefinition::GetAllTileDefinitions()) {
+        Track(def->GetSprite());
+        const auto id = def->GetDefinitionId();
+        if(id == TileDefinition::invalid_definition_id) {
+            continue;
+        }
+        if(_tile_sprites.size() <= id) {
+            _tile_sprites.resize(id + 1u, nullptr);
+        }
+        _tile_sprites[id] = def->GetSprite();
+    }
+    for(auto* def : EntityDefinition::GetAllEntityDefinitions()) {
+        Track(def->GetSprite());
+    }
+    for(auto& item : Item::s_registry) {
+        Track(item.second->GetSprite());
+    }
+    //Every tile inventory draws as a chest, so it is looked up once here rather than per tile.
+    _chest_item = Item::GetItem("chest");
+    _tracked_generation = s_definitions_generation;
+}
+
+void AnimationScheduler::Clear() noexcept {
+    _sprites.clear();
+    _changed.clear();
+    _tile_sprites.clear();
+    _chest_item = nullptr;
+    _tracked_generation = 0u;
+}
+
+bool AnimationScheduler::IsTrackingStale() const noexcept {
+    return _tracked_generation != s_definitions_generation;
+}
+
+void AnimationScheduler::InvalidateTrackedSprites() noexcept {
+    ++s_definitions_generation;
+}
+
+void AnimationScheduler::Update(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    _changed.clear();
+    for(auto* sprite : _sprites) {
+        const auto before = sprite->GetCurrentTexCoords();
+        sprite->Update(deltaSeconds);
+        const auto after = sprite->GetCurrentTexCoords();
+        if(!(before.mins == after.mins && before.maxs == after.maxs)) {
+            _changed.push_back(sprite);
+        }
+    }
+    _stats.sprites_advanced = _sprites.size();
+    _stats.frames_changed = _changed.size();
+    ResolveTileFrames();
+}
+
+//Mesh building reads these instead of looking up a definition and querying its sprite per tile.
+void AnimationScheduler::ResolveTileFrames() noexcept {
+    _tile_frames.resize(_tile_sprites.size());
+    for(auto id = std::size_t{0u}; id != _tile_sprites.size(); ++id) {
+        if(const auto* sprite = _tile_sprites[id]; sprite != nullptr) {
+            _tile_frames[id] = SpriteFrame{sprite->GetCurrentTexCoords(), sprite->GetMaterial(), HasFrameChanged(sprite)};
+        } else {
+            _tile_frames[id] = SpriteFrame{};
+        }
+    }
+}
+
+//Few sprites change frame on any given frame, so a linear search is enough.
+bool AnimationScheduler::HasFrameChanged(const AnimatedSprite* sprite) const noexcept {
+    return std::find(std::cbegin(_changed), std::cend(_changed), sprite) != std::cend(_changed);
+}
+
+bool AnimationScheduler::HasAnyFrameChanged() const noexcept {
+    return !_changed.empty();
+}
+
+const AnimationScheduler::SpriteFrame* AnimationScheduler::GetTileFrame(std::size_t definition_id) const noexcept {
+    if(definition_id < _tile_frames.size() && _tile_frames[definition_id].material != nullptr) {
+        return &_tile_frames[definition_id];
+    }
+    return nullptr;
+}
+
+const Item* AnimationScheduler::GetChestItem() const noexcept {
+    return _chest_item;
+}
+
+const AnimationScheduler::Stats& AnimationScheduler::GetStats() const noexcept {
+    return _stats;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include "Engine/Math/AABB2.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class AnimatedSprite;
+class Item;
+class Material;
+
+//Advances shared animated sprites once per frame no matter how many tiles,
+//entities or items draw them, and remembers which ones moved to a new frame.
+class AnimationScheduler {
+public:
+    struct Stats {
+        std::size_t sprites_advanced{};
+        std::size_t frames_changed{};
+    };
+
+    //A tile definition's sprite as resolved for the current frame.
+    struct SpriteFrame {
+        AABB2 uv_coords{};
+        Material* material{};
+        bool changed{false};
+    };
+
+    //Each sprite should be tracked once. Tracking lasts until the definitions are reloaded.
+    void Track(AnimatedSprite* sprite) noexcept;
+    void TrackDefinitionSprites() noexcept;
+    void Clear() noexcept;
+    bool IsTrackingStale() const noexcept;
+    //Call after loading tile, entity or item definitions; their sprites may have been replaced.
+    static void InvalidateTrackedSprites() noexcept;
+
+    void Update(TimeUtils::FPSeconds deltaSeconds) noexcept;
+
+    bool HasFrameChanged(const AnimatedSprite* sprite) const noexcept;
+    bool HasAnyFrameChanged() const noexcept;
+    //Indexed by TileDefinition::GetDefinitionId. Null for definitions without a drawable sprite.
+    const SpriteFrame* GetTileFrame(std::size_t definition_id) const noexcept;
+    const Item* GetChestItem() const noexcept;
+    const Stats& GetStats() const noexcept;
+
+protected:
+private:
+    void ResolveTileFrames() noexcept;
+
+    std::vector<AnimatedSprite*> _sprites{};
+    std::vector<const AnimatedSprite*> _tile_sprites{};
+    std::vector<SpriteFrame> _tile_frames{};
+    const Item* _chest_item{};
+    std::vector<const AnimatedSprite*> _changed{};
+    Stats _stats{};
+    uint32_t _tracked_generation{0u};
+    static inline uint32_t s_definitions_generation{1u};
+};
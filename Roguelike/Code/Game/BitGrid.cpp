@@ -0,0 +1,88 @@
+#include "Game/BitGrid.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+BitGrid::BitGrid(const IntVector2& dimensions) noexcept {
+    Resize(dimensions);
+}
+
+void BitGrid::Resize(const IntVector2& dimensions) noexcept {
+    _dimensions = dimensions;
+    _size = static_cast<std::size_t>((std::max)(0, dimensions.x)) * static_cast<std::size_t>((std::max)(0, dimensions.y));
+    _words.assign((_size + bits_per_word - 1u) / bits_per_word, word_type{0u});
+}
+
+const IntVector2& BitGrid::GetDimensions() const noexcept {
+    return _dimensions;
+}
+
+std::size_t BitGrid::size() const noexcept {
+    return _size;
+}
+
+bool BitGrid::Test(std::size_t index) const noexcept {
+    if(index >= _size) {
+        return false;
+    }
+    return (_words[index / bits_per_word] >> (index % bits_per_word)) & word_type{1u};
+}
+
+bool BitGrid::Test(const IntVector2& coords) const noexcept {
+    return IsInBounds(coords) && Test(GetIndex(coords));
+}
+
+void BitGrid::Set(std::size_t index) noexcept {
+    if(index >= _size) {
+        return;
+    }
+    _words[index / bits_per_word] |= word_type{1u} << (index % bits_per_word);
+}
+
+void BitGrid::Set(const IntVector2& coords) noexcept {
+    if(IsInBounds(coords)) {
+        Set(GetIndex(coords));
+    }
+}
+
+void BitGrid::Reset(std::size_t index) noexcept {
+    if(index >= _size) {
+        return;
+    }
+    _words[index / bits_per_word] &= ~(word_type{1u} << (index % bits_per_word));
+}
+
+void BitGrid::Reset(const IntVector2& coords) noexcept {
+    if(IsInBounds(coords)) {
+        Reset(GetIndex(coords));
+    }
+}
+
+void BitGrid::Clear() noexcept {
+    if(!_words.empty()) {
+        std::memset(_words.data(), 0, _words.size() * sizeof(word_type));
+    }
+}
+
+void BitGrid::Merge(const BitGrid& other) noexcept {
+    const auto count = (std::min)(_words.size(), other._words.size());
+    for(auto i = std::size_t{0u}; i != count; ++i) {
+        _words[i] |= other._words[i];
+    }
+}
+
+std::span<const BitGrid::word_type> BitGrid::GetWords() const noexcept {
+    return std::span<const word_type>{_words};
+}
+
+std::span<BitGrid::word_type> BitGrid::GetWords() noexcept {
+    return std::span<word_type>{_words};
+}
+
+bool BitGrid::IsInBounds(const IntVector2& coords) const noexcept {
+    return !(coords.x < 0 || coords.y < 0 || coords.x >= _dimensions.x || coords.y >= _dimensions.y);
+}
+
+std::size_t BitGrid::GetIndex(const IntVector2& coords) const noexcept {
+    return static_cast<std::size_t>(coords.y) * static_cast<std::size_t>(_dimensions.x) + static_cast<std::size_t>(coords.x);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Engine/Math/IntVector2.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//One bit per tile, packed into 64-bit words in row-major order.
+//Whole-grid operations work a word at a time.
+class BitGrid {
+public:
+    using word_type = uint64_t;
+    static constexpr std::size_t bits_per_word = sizeof(word_type) * 8u;
+
+    BitGrid() = default;
+    explicit BitGrid(const IntVector2& dimensions) noexcept;
+    BitGrid(const BitGrid& other) = default;
+    BitGrid(BitGrid&& other) = default;
+    BitGrid& operator=(const BitGrid& other) = default;
+    BitGrid& operator=(BitGrid&& other) = default;
+    ~BitGrid() = default;
+
+    void Resize(const IntVector2& dimensions) noexcept;
+    const IntVector2& GetDimensions() const noexcept;
+    std::size_t size() const noexcept;
+
+    bool Test(std::size_t index) const noexcept;
+    bool Test(const IntVector2& coords) const noexcept;
+    void Set(std::size_t index) noexcept;
+    void Set(const IntVector2& coords) noexcept;
+    void Reset(std::size_t index) noexcept;
+    void Reset(const IntVector2& coords) noexcept;
+
+    void Clear() noexcept;
+    void Merge(const BitGrid& other) noexcept;
+
+    std::span<const word_type> GetWords() const noexcept;
+    std::span<word_type> GetWords() noexcept;
+
+protected:
+private:
+    bool IsInBounds(const IntVector2& coords) const noexcept;
+    std::size_t GetIndex(const IntVector2& coords) const noexcept;
+
+    std::vector<word_type> _words{};
+    IntVector2 _dimensions{};
+    std::size_t _size{};
+};
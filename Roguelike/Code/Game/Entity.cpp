@@ -10,6 +10,7 @@
 #include "Game/GameCommon.hpp"
 #include "Game/Map.hpp"
 #include "Game/Item.hpp"
+#include "Game/QuadBatcher.hpp"
 
 Entity::~Entity() {
     /* DO NOTHING */
@@ -84,7 +85,7 @@ std::string Entity::ParseEntityDefinitionName(const XMLElement& xml_definition)
         , DataUtils::ParseXmlAttribute(xml_definition, "sex", std::string{}));
 }
 
-void Entity::AddVertsForCapeEquipment() const noexcept {
+void Entity::AddVertsForCapeEquipment(QuadBatcher& batcher) const noexcept {
     if(auto actor = dynamic_cast<const Actor*>(this)) {
         for(const auto& e : actor->GetEquipment()) {
             if(e && e->GetEquipSlot() == EquipSlot::Cape) {
@@ -96,17 +97,19 @@ void Entity::AddVertsForCapeEquipment() const noexcept {
                         const auto t = actor->tile->GetLightValue();
                         return (std::max)(a, t);
                     }();
-                    layer->AppendToMesh(_position, s->GetCurrentTexCoords(), light_value, s->GetMaterial());
+                    batcher.SetDrawOrder(QuadBatcher::DrawOrder::Cape);
+                    layer->AppendToMesh(batcher, _position, s->GetCurrentTexCoords(), light_value, s->GetMaterial());
                 }
             }
         }
     }
 }
 
-void Entity::AddVertsForEquipment() const noexcept {
+void Entity::AddVertsForEquipment(QuadBatcher& batcher) const noexcept {
     if(auto actor = dynamic_cast<const Actor*>(this)) {
-        for(const auto& e : actor->GetEquipment()) {
-            if(e && e->GetEquipSlot() != EquipSlot::Cape) {
+        const auto& equipment = actor->GetEquipment();
+        for(auto slot = std::size_t{0u}; slot != equipment.size(); ++slot) {
+            if(const auto* e = equipment[slot]; e && e->GetEquipSlot() != EquipSlot::Cape) {
                 if(const auto* s = e->GetSprite(); !s || actor->IsInvisible()) {
                     continue;
                 } else {
@@ -115,7 +118,9 @@ void Entity::AddVertsForEquipment() const noexcept {
                         const auto t = actor->tile->GetLightValue();
                         return (std::max)(a, t);
                     }();
-                    layer->AppendToMesh(_position, s->GetCurrentTexCoords(), light_value, s->GetMaterial());
+                    //Equipment order decides what draws on top, so each slot keeps its own draw order.
+                    batcher.SetDrawOrder(QuadBatcher::DrawOrder::Equipment, static_cast<uint32_t>(slot));
+                    layer->AppendToMesh(batcher, _position, s->GetCurrentTexCoords(), light_value, s->GetMaterial());
                 }
             }
         }
@@ -6,6 +6,7 @@
 #include "Engine/Core/Event.hpp"
 #include "Engine/Core/TimeUtils.hpp"
 
+#include "Engine/Renderer/Mesh.hpp"
 #include "Engine/Renderer/Vertex3D.hpp"
 
 #include "Game/Inventory.hpp"
@@ -14,6 +15,7 @@
 class AnimatedSprite;
 class Map;
 class Layer;
+class QuadBatcher;
 class Tile;
 class EntityDefinition;
 
@@ -81,8 +83,8 @@ public:
     Event<> OnMiss;
     Event<> OnDestroy;
 
-    void AddVertsForEquipment() const noexcept;
-    void AddVertsForCapeEquipment() const noexcept;
+    void AddVertsForEquipment(QuadBatcher& batcher) const noexcept;
+    void AddVertsForCapeEquipment(QuadBatcher& batcher) const noexcept;
 
 protected:
     virtual void ResolveAttack(Entity& attacker, Entity& defender);
@@ -9,6 +9,8 @@
 #include "Game/Behavior.hpp"
 #include "Game/GameCommon.hpp"
 
+#include <format>
+
 std::map<std::string, std::unique_ptr<EntityDefinition>> EntityDefinition::s_registry;
 
 void EntityDefinition::CreateEntityDefinition(const XMLElement& elem) {
@@ -44,6 +46,15 @@ std::vector<std::string> EntityDefinition::GetAllEntityDefinitionNames() {
     return result;
 }
 
+std::vector<EntityDefinition*> EntityDefinition::GetAllEntityDefinitions() {
+    std::vector<EntityDefinition*> result{};
+    result.reserve(s_registry.size());
+    for(const auto& e : s_registry) {
+        result.push_back(e.second.get());
+    }
+    return result;
+}
+
 EntityDefinition::EntityDefinition(const XMLElement& elem)
 {
     GUARANTEE_OR_DIE(LoadFromXml(elem), "Entity Definition failed to load.");
@@ -91,7 +102,7 @@ const std::vector<std::shared_ptr<class Behavior>>& EntityDefinition::GetAvailab
 }
 
 bool EntityDefinition::LoadFromXml(const XMLElement& elem) {
-    DataUtils::ValidateXmlElement(elem, "entityDefinition", "", "name,index", "animation,attachPoints,inventory,stats,equipment,behaviors");
+    DataUtils::ValidateXmlElement(elem, "entityDefinition", "", "name,index", "animation,attachPoints,inventory,stats,equipment,behaviors,fov");
 
     name = DataUtils::ParseXmlAttribute(elem, "name", name);
     _index = DataUtils::ParseXmlAttribute(elem, "index", IntVector2::Zero);
@@ -101,6 +112,7 @@ bool EntityDefinition::LoadFromXml(const XMLElement& elem) {
     LoadInventory(elem);
     LoadEquipment(elem);
     LoadBehaviors(elem);
+    LoadFieldOfView(elem);
     return true;
 }
 
@@ -143,6 +155,25 @@ void EntityDefinition::LoadBehaviors(const XMLElement& elem) {
     }
 }
 
+void EntityDefinition::LoadFieldOfView(const XMLElement& elem) {
+    if(auto* xml_fov = elem.FirstChildElement("fov")) {
+        DataUtils::ValidateXmlElement(*xml_fov, "fov", "", "", "", "mode,radius");
+        sight_radius = DataUtils::ParseXmlAttribute(*xml_fov, "radius", sight_radius);
+        const auto mode = StringUtils::ToLowerCase(DataUtils::ParseXmlAttribute(*xml_fov, "mode", std::string{"shadowcast"}));
+        if(mode == "symmetric") {
+            fov_mode = FieldOfViewMode::Symmetric;
+            if(sight_radius > static_cast<float>(FieldOfView::max_symmetric_radius)) {
+                DebuggerPrintf(std::format("Symmetric field of view supports a radius of at most {}. Falling back to shadowcasting.\n", FieldOfView::max_symmetric_radius));
+            }
+        } else if(mode == "shadowcast") {
+            fov_mode = FieldOfViewMode::Shadowcast;
+        } else {
+            DebuggerPrintf("Invalid fov mode value. Defaulting to shadowcast.\n");
+            fov_mode = FieldOfViewMode::Shadowcast;
+        }
+    }
+}
+
 void EntityDefinition::LoadAttachPoints(const XMLElement& elem) {
     if(auto* xml_attachPoints = elem.FirstChildElement("attachPoints")) {
         DataUtils::ValidateXmlElement(*xml_attachPoints, "attachPoints", "", "", "cape,hair,head,body,larm,rarm,legs,feet");
@@ -3,6 +3,8 @@
 #include "Engine/Core/DataUtils.hpp"
 #include "Engine/Renderer/AnimatedSprite.hpp"
 
+#include "Game/FieldOfView.hpp"
+#include "Game/GameCommon.hpp"
 #include "Game/Inventory.hpp"
 #include "Game/Stats.hpp"
 #include "Game/Item.hpp"
@@ -37,6 +39,7 @@ public:
     static EntityDefinition* GetEntityDefinitionByName(const std::string& name);
     static void ClearEntityRegistry();
     static std::vector<std::string> GetAllEntityDefinitionNames();
+    static std::vector<EntityDefinition*> GetAllEntityDefinitions();
 
     EntityDefinition() = delete;
     EntityDefinition(const EntityDefinition& other) = default;
@@ -53,6 +56,8 @@ public:
     bool is_solid = false;
     bool is_opaque = false;
     bool is_animated = false;
+    FieldOfViewMode fov_mode{FieldOfViewMode::Shadowcast};
+    float sight_radius{default_actor_sight_radius};
     Inventory inventory{};
     std::vector<Item*> equipment = std::vector<Item*>(static_cast<std::size_t>(EquipSlot::Max));
 
@@ -77,6 +82,7 @@ private:
     void LoadInventory(const XMLElement& elem);
     void LoadEquipment(const XMLElement& elem);
     void LoadBehaviors(const XMLElement& elem);
+    void LoadFieldOfView(const XMLElement& elem);
 
     static std::map<std::string, std::unique_ptr<EntityDefinition>> s_registry;
     std::shared_ptr<class SpriteSheet> _sheet{};
@@ -4,6 +4,7 @@
 
 #include "Game/GameCommon.hpp"
 #include "Game/Map.hpp"
+#include "Game/RenderRecorder.hpp"
 
 #include <algorithm>
 
@@ -43,6 +44,10 @@ void EntityText::Render() const {
     g_theRenderer->DrawTextLine(font, text, color);
 }
 
+void EntityText::Record(RenderRecorder& recorder) const noexcept {
+    recorder.DrawTextLine(text);
+}
+
 void EntityText::EndFrame() {
     for(auto* e : this->map->GetTextEntities()) {
         if(e != this) {
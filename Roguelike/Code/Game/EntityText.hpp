@@ -9,6 +9,7 @@
 #include <memory>
 
 class KerningFont;
+class RenderRecorder;
 
 struct TextEntityDesc {
     std::string text = "DAMAGE";
@@ -37,6 +38,7 @@ public:
 
     void Update(TimeUtils::FPSeconds deltaSeconds) override;
     void Render() const;
+    void Record(RenderRecorder& recorder) const noexcept;
     void EndFrame() override;
 
 protected:
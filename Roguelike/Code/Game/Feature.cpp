@@ -183,23 +183,31 @@ bool Feature::IsInvisible() const noexcept {
 void Feature::SetPosition(const IntVector2& position) {
     auto cur_tile = map->GetTile(_position.x, _position.y, layer->z_index);
     cur_tile->feature = nullptr;
+    layer->UpdateOpacityAt(cur_tile->GetCoords());
     Entity::SetPosition(position);
     auto next_tile = map->GetTile(_position.x, _position.y, layer->z_index);
     next_tile->feature = this;
+    layer->UpdateOpacityAt(next_tile->GetCoords());
     tile = next_tile;
 }
 
 void Feature::SetState(const std::string& stateName) {
     if(auto* new_def = TileDefinition::GetTileDefinitionByName(GetFullyQualifiedNameFromState(stateName))) {
         TileInfo ti{layer, tile->GetIndexFromCoords()};
+        const auto was_opaque = IsOpaque();
         sprite = new_def->GetSprite();
         _light_value = new_def->light;
         _self_illumination = new_def->self_illumination;
-        ti.SetLightDirty();
+        map->DirtyTileLight(ti);
         CalculateLightValue();
         if(auto iter = std::find(std::begin(_states), std::end(_states), stateName); iter != std::end(_states)) {
             _current_state = iter;
         }
+        //Opening or closing a door changes how baked light spreads through the tile.
+        if(was_opaque != IsOpaque()) {
+            layer->DirtyStaticLight();
+            layer->UpdateOpacityAt(tile->GetCoords());
+        }
         return;
     }
     DebuggerPrintf(std::format("Attempting to set Feature to invalid state: {}\n", stateName));
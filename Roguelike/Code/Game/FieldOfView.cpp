@@ -0,0 +1,55 @@
+#include "Game/FieldOfView.hpp"
+
+#include <algorithm>
+
+namespace {
+
+//Coordinates are doubled so tile corners land on integers and the test is exact.
+//The segment runs from the window center to the center of the target cell.
+bool DoesSegmentCrossTileInterior(const IntVector2& target, const IntVector2& tile) noexcept {
+    const auto end = IntVector2{2 * target.x, 2 * target.y};
+    const auto mins = IntVector2{2 * tile.x - 1, 2 * tile.y - 1};
+    const auto maxs = IntVector2{2 * tile.x + 1, 2 * tile.y + 1};
+    if((std::max)(0, end.x) <= mins.x || (std::min)(0, end.x) >= maxs.x) {
+        return false;
+    }
+    if((std::max)(0, end.y) <= mins.y || (std::min)(0, end.y) >= maxs.y) {
+        return false;
+    }
+    //The segment's line must split the open square, not merely touch it.
+    bool any_below = false;
+    bool any_above = false;
+    for(const auto& corner : {mins, IntVector2{mins.x, maxs.y}, maxs, IntVector2{maxs.x, mins.y}}) {
+        const auto side = end.x * corner.y - end.y * corner.x;
+        any_below |= side < 0;
+        any_above |= side > 0;
+    }
+    return any_below && any_above;
+}
+
+std::array<FieldOfView::BlockerMask, FieldOfView::symmetric_cell_count> BuildSymmetricTable() noexcept {
+    std::array<FieldOfView::BlockerMask, FieldOfView::symmetric_cell_count> table{};
+    const auto offset_of = [](std::size_t cell) {
+        return IntVector2{static_cast<int>(cell % FieldOfView::symmetric_window_size) - FieldOfView::max_symmetric_radius, static_cast<int>(cell / FieldOfView::symmetric_window_size) - FieldOfView::max_symmetric_radius};
+    };
+    for(auto target = std::size_t{0u}; target != FieldOfView::symmetric_cell_count; ++target) {
+        const auto target_offset = offset_of(target);
+        for(auto cell = std::size_t{0u}; cell != FieldOfView::symmetric_cell_count; ++cell) {
+            const auto cell_offset = offset_of(cell);
+            if(cell_offset == IntVector2::Zero || cell_offset == target_offset) {
+                continue;
+            }
+            if(DoesSegmentCrossTileInterior(target_offset, cell_offset)) {
+                table[target][cell / 64u] |= uint64_t{1u} << (cell % 64u);
+            }
+        }
+    }
+    return table;
+}
+
+} // namespace
+
+const std::array<FieldOfView::BlockerMask, FieldOfView::symmetric_cell_count>& FieldOfView::GetSymmetricTable() noexcept {
+    static const auto table = BuildSymmetricTable();
+    return table;
+}
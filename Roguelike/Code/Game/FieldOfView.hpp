@@ -0,0 +1,168 @@
+#pragma once
+
+#include "Engine/Math/IntVector2.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+
+enum class FieldOfViewMode {
+    Shadowcast
+    ,Symmetric
+};
+
+//Recursive shadowcasting. Only tiles within the radius of the origin are touched,
+//so the cost depends on the view radius and not on the size of the map.
+//Radii up to max_symmetric_radius may instead use the symmetric lookup-table mode.
+class FieldOfView {
+public:
+    static constexpr int max_symmetric_radius = 8;
+    static constexpr int symmetric_window_size = 2 * max_symmetric_radius + 1;
+    static constexpr std::size_t symmetric_cell_count = static_cast<std::size_t>(symmetric_window_size) * symmetric_window_size;
+    using BlockerMask = std::array<uint64_t, (symmetric_cell_count + 63u) / 64u>;
+
+    //Symmetric mode falls back to shadowcasting for radii it has no table for.
+    template<typename IsOpaque, typename OnVisible>
+    static void Calculate(FieldOfViewMode mode, const IntVector2& origin, float radius, const IntVector2& dimensions, IsOpaque&& isOpaque, OnVisible&& onVisible) noexcept {
+        if(mode == FieldOfViewMode::Symmetric && radius <= static_cast<float>(max_symmetric_radius)) {
+            CalculateSymmetric(origin, radius, dimensions, isOpaque, onVisible);
+        } else {
+            Calculate(origin, radius, dimensions, isOpaque, onVisible);
+        }
+    }
+
+    //A tile is visible when the segment between the two tile centers passes through the
+    //interior of no opaque tile. The segment is the same in both directions, so A seeing B
+    //always means B sees A. Grazing a corner does not block, which makes it permissive.
+    template<typename IsOpaque, typename OnVisible>
+    static void CalculateSymmetric(const IntVector2& origin, float radius, const IntVector2& dimensions, IsOpaque&& isOpaque, OnVisible&& onVisible) noexcept {
+        if(!IsInBounds(origin, dimensions) || radius < 0.0f || radius > static_cast<float>(max_symmetric_radius)) {
+            return;
+        }
+        BlockerMask opaque{};
+        for(auto cell = std::size_t{0u}; cell != symmetric_cell_count; ++cell) {
+            const auto coords = origin + GetSymmetricOffset(cell);
+            if(!IsInBounds(coords, dimensions) || std::invoke(isOpaque, coords)) {
+                opaque[cell / 64u] |= uint64_t{1u} << (cell % 64u);
+            }
+        }
+        const auto& table = GetSymmetricTable();
+        const auto radius_sq = radius * radius;
+        std::invoke(onVisible, origin);
+        for(auto cell = std::size_t{0u}; cell != symmetric_cell_count; ++cell) {
+            const auto offset = GetSymmetricOffset(cell);
+            if(offset == IntVector2::Zero || static_cast<float>(offset.x * offset.x + offset.y * offset.y) >= radius_sq) {
+                continue;
+            }
+            const auto coords = origin + offset;
+            if(!IsInBounds(coords, dimensions)) {
+                continue;
+            }
+            uint64_t blocked{0u};
+            for(auto word = std::size_t{0u}; word != opaque.size(); ++word) {
+                blocked |= table[cell][word] & opaque[word];
+            }
+            if(!blocked) {
+                std::invoke(onVisible, coords);
+            }
+        }
+    }
+
+    //IsOpaque: bool(const IntVector2&), OnVisible: void(const IntVector2&)
+    //Coordinates outside of dimensions are treated as opaque and never reported.
+    template<typename IsOpaque, typename OnVisible>
+    static void Calculate(const IntVector2& origin, float radius, const IntVector2& dimensions, IsOpaque&& isOpaque, OnVisible&& onVisible) noexcept {
+        if(!IsInBounds(origin, dimensions) || radius < 0.0f) {
+            return;
+        }
+        std::invoke(onVisible, origin);
+        const auto context = Context<IsOpaque, OnVisible>{origin, dimensions, radius * radius, static_cast<int>(std::ceil(radius)), isOpaque, onVisible};
+        for(const auto& octant : octants) {
+            CastLight(context, 1, 1.0f, 0.0f, octant);
+        }
+    }
+
+protected:
+private:
+    struct Octant {
+        int xx{};
+        int xy{};
+        int yx{};
+        int yy{};
+    };
+
+    template<typename IsOpaque, typename OnVisible>
+    struct Context {
+        IntVector2 origin{};
+        IntVector2 dimensions{};
+        float radius_sq{};
+        int radius{};
+        IsOpaque& isOpaque;
+        OnVisible& onVisible;
+    };
+
+    static constexpr std::array<Octant, 8> octants{
+        Octant{1, 0, 0, 1}
+        , Octant{0, 1, 1, 0}
+        , Octant{0, -1, 1, 0}
+        , Octant{-1, 0, 0, 1}
+        , Octant{-1, 0, 0, -1}
+        , Octant{0, -1, -1, 0}
+        , Octant{0, 1, -1, 0}
+        , Octant{1, 0, 0, -1}
+    };
+
+    static constexpr bool IsInBounds(const IntVector2& coords, const IntVector2& dimensions) noexcept {
+        return !(coords.x < 0 || coords.y < 0 || coords.x >= dimensions.x || coords.y >= dimensions.y);
+    }
+
+    static IntVector2 GetSymmetricOffset(std::size_t cell) noexcept {
+        return IntVector2{static_cast<int>(cell % symmetric_window_size) - max_symmetric_radius, static_cast<int>(cell / symmetric_window_size) - max_symmetric_radius};
+    }
+
+    //For each cell of the window, the cells whose interior the segment from the center crosses.
+    static const std::array<BlockerMask, symmetric_cell_count>& GetSymmetricTable() noexcept;
+
+    template<typename IsOpaque, typename OnVisible>
+    static void CastLight(const Context<IsOpaque, OnVisible>& context, int row, float start_slope, float end_slope, const Octant& octant) noexcept {
+        if(start_slope < end_slope) {
+            return;
+        }
+        float next_start_slope = start_slope;
+        for(int distance = row; distance <= context.radius; ++distance) {
+            bool blocked = false;
+            const int dy = -distance;
+            for(int dx = -distance; dx <= 0; ++dx) {
+                const float left_slope = (dx - 0.5f) / (dy + 0.5f);
+                const float right_slope = (dx + 0.5f) / (dy - 0.5f);
+                if(start_slope < right_slope) {
+                    continue;
+                } else if(end_slope > left_slope) {
+                    break;
+                }
+                const auto coords = IntVector2{context.origin.x + dx * octant.xx + dy * octant.xy, context.origin.y + dx * octant.yx + dy * octant.yy};
+                const bool in_bounds = IsInBounds(coords, context.dimensions);
+                if(in_bounds && static_cast<float>(dx * dx + dy * dy) < context.radius_sq) {
+                    std::invoke(context.onVisible, coords);
+                }
+                const bool opaque = !in_bounds || std::invoke(context.isOpaque, coords);
+                if(blocked) {
+                    if(opaque) {
+                        next_start_slope = right_slope;
+                        continue;
+                    }
+                    blocked = false;
+                    start_slope = next_start_slope;
+                } else if(opaque && distance < context.radius) {
+                    blocked = true;
+                    CastLight(context, distance + 1, start_slope, left_slope, octant);
+                    next_start_slope = right_slope;
+                }
+            }
+            if(blocked) {
+                break;
+            }
+        }
+    }
+};
@@ -26,6 +26,10 @@ FleeBehavior::FleeBehavior() noexcept
 
 void FleeBehavior::Act(Actor* actor) noexcept {
     const auto* player = actor->map->player;
+    //Only flee from a player the actor can actually see.
+    if(player == nullptr || !actor->CanSee(*player)) {
+        return;
+    }
     const auto* player_tile = player->tile;
     int x = -1;
     int y = -1;
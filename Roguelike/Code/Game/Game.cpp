@@ -24,17 +24,23 @@
 
 #include "Engine/RHI/RHIOutput.hpp"
 
+#include "Engine/Services/ServiceLocator.hpp"
+#include "Engine/Services/IFileLoggerService.hpp"
+
 #include "Game/GameCommon.hpp"
 #include "Game/GameConfig.hpp"
 #include "Game/Entity.hpp"
 #include "Game/Actor.hpp"
+#include "Game/AnimationScheduler.hpp"
 #include "Game/Feature.hpp"
 #include "Game/Cursor.hpp"
 #include "Game/CursorDefinition.hpp"
 #include "Game/EntityDefinition.hpp"
 #include "Game/Layer.hpp"
+#include "Game/LightingHarness.hpp"
 #include "Game/Map.hpp"
 #include "Game/Editor/MapEditor.hpp"
+#include "Game/ScriptedFrameRunner.hpp"
 #include "Game/Tile.hpp"
 #include "Game/TileDefinition.hpp"
 #include "Game/Item.hpp"
@@ -42,6 +48,10 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <numbers>
 #include <numeric>
 #include <string>
 #include <utility>
@@ -168,6 +178,7 @@ void Game::Initialize() noexcept {
     OnMapEnter.Subscribe_method(this, &Game::MapEntered);
 
     _consoleCommands = Console::CommandList(g_theConsole);
+    CreateConsoleCommands();
     CreateFullscreenConstantBuffer();
     g_theRenderer->RegisterMaterialsFromFolder(std::string{"Data/Materials"});
     g_theRenderer->RegisterFontsFromFolder(std::string{"Data/Fonts"});
@@ -607,6 +618,112 @@ void Game::RegisterCommands() {
     g_theConsole->PushCommandList(_consoleCommands);
 }
 
+void Game::CreateConsoleCommands() noexcept {
+    {
+        Console::Command lighting_bench{};
+        lighting_bench.command_name = "lighting_bench";
+        lighting_bench.help_text_short = "Benchmarks and verifies map lighting.";
+        lighting_bench.help_text_long = "lighting_bench: Relights every map in Data/Maps and several generated maps, logging tiles processed, queue peak, and time for each scenario and comparing the result against a brute-force reference.";
+        lighting_bench.command_function = [this](const std::string& /*args*/) { RunLightingHarness(); };
+        _consoleCommands.AddCommand(lighting_bench);
+    }
+    {
+        Console::Command raycast_bench{};
+        raycast_bench.command_name = "raycast_bench";
+        raycast_bench.help_text_short = "Compares scalar and batched line of sight.";
+        raycast_bench.help_text_long = "raycast_bench: Casts rings of 64 and 256 rays from the player one at a time and as a batch, logging the time for each and any rays whose results differ.";
+        raycast_bench.command_function = [this](const std::string& /*args*/) { RunRaycastBenchmark(); };
+        _consoleCommands.AddCommand(raycast_bench);
+    }
+    {
+        Console::Command frame_bench{};
+        frame_bench.command_name = "frame_bench";
+        frame_bench.help_text_short = "Runs scripted frames of a fresh copy of the current map without drawing.";
+        frame_bench.help_text_long = "frame_bench [script]: Loads the current map's file again and runs the frames in the script (default Data/Scripts/frame_bench.txt) against that copy, recording render submissions instead of drawing, and logs update and record time per frame with mesh, draw range, vertex and text counts. It still runs inside the game and needs its renderer; the map being played is not touched.";
+        frame_bench.command_function = [this](const std::string& args) { RunFrameBenchmark(args); };
+        _consoleCommands.AddCommand(frame_bench);
+    }
+}
+
+void Game::RunLightingHarness() noexcept {
+    LightingHarness harness{};
+    harness.RunAll(std::filesystem::path{"Data/Maps"});
+    harness.LogResults();
+    RestoreMapStatsCallback();
+}
+
+//Every Map constructed or destroyed outside the adventure replaces the stat window callback.
+void Game::RestoreMapStatsCallback() noexcept {
+    if(_adventure) {
+        if(auto* map = _adventure->CurrentMapOrNull()) {
+            g_theUISystem->SetClayLayoutCallback([map]() {
+                map->RenderClayStatsBlock();
+            });
+        }
+    }
+}
+
+void Game::RunRaycastBenchmark() noexcept {
+    auto* logger = ServiceLocator::get<IFileLoggerService>();
+    const auto* map = _adventure ? _adventure->CurrentMapOrNull() : nullptr;
+    if(map == nullptr || map->player == nullptr) {
+        logger->LogWarnLine("raycast_bench: No map or player.");
+        return;
+    }
+    const auto origin = Vector2{map->player->GetPosition()} + Vector2{0.5f, 0.5f};
+    static constexpr float radius = 12.0f;
+    static constexpr int iterations = 1000;
+    for(const auto ray_count : {std::size_t{64u}, std::size_t{256u}}) {
+        std::vector<Vector2> ends(ray_count);
+        for(auto i = std::size_t{0u}; i != ray_count; ++i) {
+            const auto angle = 2.0f * std::numbers::pi_v<float> * static_cast<float>(i) / static_cast<float>(ray_count);
+            ends[i] = origin + Vector2{std::cos(angle), std::sin(angle)} * radius;
+        }
+        std::vector<Map::RaycastHit2D> scalar_results(ray_count);
+        std::vector<Map::RaycastHit2D> batch_results(ray_count);
+        const auto scalar_start = std::chrono::steady_clock::now();
+        for(int iteration = 0; iteration != iterations; ++iteration) {
+            for(auto i = std::size_t{0u}; i != ray_count; ++i) {
+                scalar_results[i] = map->HasLineOfSight(origin, ends[i]);
+            }
+        }
+        const auto batch_start = std::chrono::steady_clock::now();
+        for(int iteration = 0; iteration != iterations; ++iteration) {
+            map->HasLineOfSight(origin, ends, batch_results);
+        }
+        const auto batch_end = std::chrono::steady_clock::now();
+        const auto mismatches = std::inner_product(std::cbegin(scalar_results), std::cend(scalar_results), std::cbegin(batch_results), std::size_t{0u}, std::plus<>{}, [](const Map::RaycastHit2D& a, const Map::RaycastHit2D& b) {
+            return std::size_t{a.didImpact != b.didImpact || (a.didImpact && a.impactTileCoords != b.impactTileCoords)};
+        });
+        const auto scalar_time = TimeUtils::FPMilliseconds{batch_start - scalar_start};
+        const auto batch_time = TimeUtils::FPMilliseconds{batch_end - batch_start};
+        logger->LogLine(std::format("raycast_bench: {0} rays x {1}: scalar {2:.3f} ms, batch {3:.3f} ms ({4:.2f}x), {5} mismatches", ray_count, iterations, scalar_time.count(), batch_time.count(), scalar_time.count() / (std::max)(batch_time.count(), 0.001f), mismatches));
+    }
+    logger->LogLineAndFlush("raycast_bench: done");
+}
+
+void Game::RunFrameBenchmark(const std::string& args) noexcept {
+    auto* logger = ServiceLocator::get<IFileLoggerService>();
+    const auto* current_map = _adventure ? _adventure->CurrentMapOrNull() : nullptr;
+    if(current_map == nullptr || current_map->GetFilepath().empty()) {
+        logger->LogWarnLine("frame_bench: No map loaded from a file.");
+        return;
+    }
+    const auto script = std::filesystem::path{args.empty() ? std::string{"Data/Scripts/frame_bench.txt"} : args};
+    ScriptedFrameRunner runner{};
+    if(!runner.LoadScript(script)) {
+        logger->LogWarnLine(std::format("frame_bench: Could not load script {}.", script.string()));
+        return;
+    }
+    logger->LogLine(std::format("frame_bench: Running a fresh copy of {} without drawing; the map being played is not touched.", current_map->GetFilepath().string()));
+    {
+        auto map = std::make_unique<Map>(current_map->GetFilepath());
+        runner.Run(*map);
+    }
+    RestoreMapStatsCallback();
+    runner.LogResults();
+}
+
 void Game::UnRegisterCommands() {
     g_theConsole->PopCommandList(_consoleCommands);
 }
@@ -794,6 +911,7 @@ void Game::LoadEntityDefinitionsFromFile(const std::filesystem::path& src) {
             [this](const XMLElement& elem) {
                 EntityDefinition::CreateEntityDefinition(elem, _entity_sheet);
             });
+        AnimationScheduler::InvalidateTrackedSprites();
     }
 }
 
@@ -811,6 +929,7 @@ void Game::LoadItemsFromFile(const std::filesystem::path& src) {
             ItemBuilder builder(elem, _item_sheet);
             builder.Build();
             });
+        AnimationScheduler::InvalidateTrackedSprites();
     }
 }
 
@@ -830,6 +949,7 @@ void Game::LoadTileDefinitionsFromFile(const std::filesystem::path& src) {
                         def->GetSprite()->SetMaterial(GetDefaultTileMaterial());
                     }
                 });
+                AnimationScheduler::InvalidateTrackedSprites();
             }
         }
     }
@@ -1436,6 +1556,42 @@ void Game::ShowWorldInspectorUI() {
         }
         ImGui::Text("Tiles in view: %llu", _adventure->CurrentMap()->DebugTilesInViewCount());
         ImGui::Text("Tiles visible in view: %llu", _adventure->CurrentMap()->DebugVisibleTilesInViewCount());
+        ImGui::Text("Chunks rebuilt: %llu (%.3f ms)", _adventure->CurrentMap()->DebugChunksRebuiltCount(), _adventure->CurrentMap()->DebugChunkBuildTime().count());
+        static bool parallel_chunk_builds = true;
+        ImGui::Checkbox("Parallel Chunk Builds", &parallel_chunk_builds);
+        _adventure->CurrentMap()->SetParallelChunkBuilds(parallel_chunk_builds);
+        {
+            const auto terrain_stats = _adventure->CurrentMap()->DebugTerrainBatchStats();
+            ImGui::Text("Terrain draw ranges in rebuilt chunks: %llu (%llu unbatched)", terrain_stats.draw_ranges, terrain_stats.unbatched_draw_ranges);
+            ImGui::Text("Terrain vertices: %llu, indices: %llu", terrain_stats.vertices, terrain_stats.indices);
+        }
+        {
+            const auto batch_stats = _adventure->CurrentMap()->DebugDynamicBatchStats();
+            ImGui::Text("Dynamic draw ranges: %llu (%llu unbatched)", batch_stats.draw_ranges, batch_stats.unbatched_draw_ranges);
+            ImGui::Text("Dynamic vertices: %llu, indices: %llu", batch_stats.vertices, batch_stats.indices);
+        }
+        {
+            const auto pool_stats = _adventure->CurrentMap()->DebugBuilderPoolStats();
+            ImGui::Text("Mesh builders: %llu (%llu in use), %llu reallocations", pool_stats.builders, pool_stats.in_use, pool_stats.reallocations);
+        }
+        {
+            const auto& animation_stats = _adventure->CurrentMap()->GetAnimationScheduler().GetStats();
+            ImGui::Text("Animations: %llu advanced, %llu changed frame", animation_stats.sprites_advanced, animation_stats.frames_changed);
+        }
+        static bool build_tile_instances = false;
+        ImGui::Checkbox("Build Tile Instances", &build_tile_instances);
+        _adventure->CurrentMap()->SetBuildTileInstances(build_tile_instances);
+        if(build_tile_instances) {
+            const auto instance_count = _adventure->CurrentMap()->DebugTileInstanceCount();
+            ImGui::Text("Tile instances: %llu, %llu bytes (%llu as quads), %.3f ms", instance_count, _adventure->CurrentMap()->DebugTileInstanceBytes(), TileInstanceStream::GetExpandedByteSize(instance_count), _adventure->CurrentMap()->DebugTileInstanceBuildTime().count());
+        }
+        static bool build_tile_vertices = false;
+        ImGui::Checkbox("Build Quantized Tile Vertices", &build_tile_vertices);
+        _adventure->CurrentMap()->SetBuildTileVertices(build_tile_vertices);
+        if(build_tile_vertices) {
+            const auto quad_count = _adventure->CurrentMap()->DebugTileVertexQuadCount();
+            ImGui::Text("Quantized tiles: %llu, %llu vertex bytes (%llu as Vertex3D), %.3f ms", quad_count, _adventure->CurrentMap()->DebugTileVertexBytes(), TileVertexStream::GetExpandedByteSize(quad_count), _adventure->CurrentMap()->DebugTileVertexBuildTime().count());
+        }
         static bool show_camera = false;
         ImGui::Checkbox("Show Camera", &show_camera);
         _debug_show_camera = show_camera;
@@ -257,6 +257,11 @@ private:
 
     void RegisterCommands();
     void UnRegisterCommands();
+    void CreateConsoleCommands() noexcept;
+    void RunLightingHarness() noexcept;
+    void RunRaycastBenchmark() noexcept;
+    void RunFrameBenchmark(const std::string& args) noexcept;
+    void RestoreMapStatsCallback() noexcept;
 
     void LoadData(void* user_data);
 
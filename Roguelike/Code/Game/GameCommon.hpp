@@ -22,19 +22,19 @@ constexpr int night_light_value{3};
 constexpr int max_light_value{15};
 constexpr float min_light_scale{0.0f};
 constexpr float max_light_scale{1.0f};
+constexpr float default_actor_sight_radius{8.0f};
+constexpr int remembered_light_value{2};
 
 constexpr uint32_t tile_coords_y_mask         {0b1111'1111'0000'0000'0000'0000'0000'0000u};
 constexpr uint32_t tile_coords_x_mask         {0b0000'0000'1111'1111'0000'0000'0000'0000u};
 constexpr uint32_t tile_coords_mask{tile_coords_y_mask | tile_coords_x_mask};
 constexpr uint32_t tile_flags_light_mask      {0b0000'0000'0000'0000'0000'0000'0000'1111u};
-constexpr uint32_t tile_flags_have_seen_mask  {0b0000'0000'0000'0000'0000'0010'0000'0000u};
-constexpr uint32_t tile_flags_can_see_mask    {0b0000'0000'0000'0000'0000'0001'0000'0000u};
 constexpr uint32_t tile_flags_sky_mask        {0b0000'0000'0000'0000'0000'0000'1000'0000u};
 constexpr uint32_t tile_flags_dirty_light_mask{0b0000'0000'0000'0000'0000'0000'0100'0000u};
 constexpr uint32_t tile_flags_opaque_mask     {0b0000'0000'0000'0000'0000'0000'0010'0000u};
 constexpr uint32_t tile_flags_solid_mask      {0b0000'0000'0000'0000'0000'0000'0001'0000u};
 constexpr uint32_t tile_flags_opaque_solid_mask{tile_flags_opaque_mask | tile_flags_solid_mask};
-constexpr uint32_t tile_flags_mask{tile_flags_opaque_solid_mask | tile_flags_dirty_light_mask | tile_flags_sky_mask | tile_flags_can_see_mask | tile_flags_have_seen_mask};
+constexpr uint32_t tile_flags_mask{tile_flags_opaque_solid_mask | tile_flags_dirty_light_mask | tile_flags_sky_mask};
 constexpr uint32_t tile_y_bits{8u};
 constexpr uint32_t tile_x_bits{8u};
 constexpr uint32_t tile_flags_bits{8u};
@@ -12,19 +12,32 @@
 #include "Game/CursorDefinition.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/GameConfig.hpp"
+#include "Game/FieldOfView.hpp"
 #include "Game/Map.hpp"
 #include "Game/Actor.hpp"
 #include "Game/Feature.hpp"
+#include "Game/RenderRecorder.hpp"
 #include "Game/TileDefinition.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iterator>
+#include <memory>
 #include <numeric>
+#include <thread>
 #include <tuple>
 
 static std::tuple<Vector2, Vector2, Vector2, Vector2> VertsFromTileCoords(const IntVector2& tile_coords) noexcept;
 static std::tuple<Vector2, Vector2, Vector2, Vector2> UVsFromUVCoords(const AABB2& uv_coords) noexcept;
 
+//Shared by the main thread and chunk build jobs. Owned jointly so a job that starts after the
+//build finished only touches this, never the layer.
+struct ChunkBuildProgress {
+    std::atomic<std::size_t> next{0u};
+    std::atomic<std::size_t> finished{0u};
+};
+
 
 Layer::Layer(Map* map, const XMLElement& elem)
     : m_map(map)
@@ -48,40 +61,355 @@ Layer::Layer(Map* map, const IntVector2& dimensions)
     for(std::size_t index{0u}; index != m_tiles.size(); ++index) {
         m_tiles[index].layer = this;
         m_tiles[index].SetCoords(index);
+        m_tiles[index].ResolveDefinition();
+    }
+    InitializeBitGrids();
+}
+
+void Layer::DirtyMesh() noexcept {
+    for(auto& chunk : m_render_chunks) {
+        chunk.dirty = true;
+    }
+}
+
+void Layer::DirtyMeshAt(const IntVector2& tile_coords) noexcept {
+    if(tile_coords.x < 0 || tile_coords.y < 0 || tile_coords.x >= tileDimensions.x || tile_coords.y >= tileDimensions.y) {
+        return;
+    }
+    InitializeRenderChunks();
+    m_render_chunks[GetChunkIndex(tile_coords)].dirty = true;
+}
+
+IntVector2 Layer::GetChunkDimensions() const noexcept {
+    if(m_map) {
+        return m_map->GetChunkDimensions();
+    }
+    return IntVector2{16, 16};
+}
+
+IntVector2 Layer::GetChunkCount() const noexcept {
+    const auto chunk_dims = GetChunkDimensions();
+    return IntVector2{(tileDimensions.x + chunk_dims.x - 1) / chunk_dims.x, (tileDimensions.y + chunk_dims.y - 1) / chunk_dims.y};
+}
+
+std::size_t Layer::GetChunkIndex(const IntVector2& tile_coords) const noexcept {
+    const auto chunk_dims = GetChunkDimensions();
+    const auto chunk_count = GetChunkCount();
+    return static_cast<std::size_t>(tile_coords.x / chunk_dims.x) + static_cast<std::size_t>(tile_coords.y / chunk_dims.y) * chunk_count.x;
+}
+
+//New chunks start dirty, so resizing after the chunk size or layer size changes rebuilds everything.
+void Layer::InitializeRenderChunks() noexcept {
+    const auto chunk_count = GetChunkCount();
+    const auto count = static_cast<std::size_t>(chunk_count.x) * chunk_count.y;
+    if(m_render_chunks.size() != count) {
+        for(const auto& chunk : m_render_chunks) {
+            if(chunk.builder != MeshBuilderPool::invalid_handle) {
+                m_builder_pool.Release(chunk.builder);
+            }
+        }
+        m_render_chunks.clear();
+        m_render_chunks.resize(count);
+    }
+}
+
+//Only chunks in view hold a builder. A chunk that scrolls out hands its builder, and the
+//storage it grew, to the next chunk that scrolls in, and is rebuilt when it comes back.
+void Layer::UpdateChunkBuilders() noexcept {
+    const auto chunk_count = GetChunkCount();
+    for(int y = 0; y < chunk_count.y; ++y) {
+        for(int x = 0; x < chunk_count.x; ++x) {
+            auto& chunk = m_render_chunks[static_cast<std::size_t>(x) + static_cast<std::size_t>(y) * chunk_count.x];
+            const auto in_view = !IsViewChunkBoundsEmpty() && x >= m_view_chunk_mins.x && x <= m_view_chunk_maxs.x && y >= m_view_chunk_mins.y && y <= m_view_chunk_maxs.y;
+            if(in_view && chunk.builder == MeshBuilderPool::invalid_handle) {
+                chunk.builder = m_builder_pool.Acquire();
+                chunk.dirty = true;
+            } else if(!in_view && chunk.builder != MeshBuilderPool::invalid_handle) {
+                m_builder_pool.Release(chunk.builder);
+                chunk.builder = MeshBuilderPool::invalid_handle;
+                chunk.batcher.Clear();
+                chunk.animated_tiles.clear();
+                chunk.dirty = true;
+            }
+        }
+    }
+}
+
+std::pair<IntVector2, IntVector2> Layer::GetChunkTileBounds(const IntVector2& chunk_coords) const noexcept {
+    const auto chunk_dims = GetChunkDimensions();
+    const auto mins = IntVector2{chunk_coords.x * chunk_dims.x, chunk_coords.y * chunk_dims.y};
+    const auto maxs = IntVector2{(std::min)(mins.x + chunk_dims.x - 1, tileDimensions.x - 1), (std::min)(mins.y + chunk_dims.y - 1, tileDimensions.y - 1)};
+    return std::make_pair(mins, maxs);
+}
+
+bool Layer::IsViewChunkBoundsEmpty() const noexcept {
+    return m_view_chunk_maxs.x < m_view_chunk_mins.x || m_view_chunk_maxs.y < m_view_chunk_mins.y;
+}
+
+void Layer::UpdateViewChunkBounds() noexcept {
+    if(m_mesh_bounds_maxs.x < m_mesh_bounds_mins.x || m_mesh_bounds_maxs.y < m_mesh_bounds_mins.y) {
+        m_view_chunk_mins = IntVector2{};
+        m_view_chunk_maxs = IntVector2{-1, -1};
+        return;
+    }
+    const auto chunk_dims = GetChunkDimensions();
+    m_view_chunk_mins = IntVector2{m_mesh_bounds_mins.x / chunk_dims.x, m_mesh_bounds_mins.y / chunk_dims.y};
+    m_view_chunk_maxs = IntVector2{m_mesh_bounds_maxs.x / chunk_dims.x, m_mesh_bounds_maxs.y / chunk_dims.y};
+}
+
+//Chunks hold terrain only, so only chunks dirtied by a tile, light or visibility change,
+//or by an animation frame change, are rebuilt; every other chunk in view is drawn from
+//the vertices it already has.
+//Each chunk collects its quads in its own batcher, one draw range per material, and flushes
+//them into its own builder. Chunks are drawn in index order, so building them on
+//job system workers gives the same result as building them here.
+//The main thread claims chunks from the same counter as the jobs and only waits for chunks
+//a running job has already claimed. If jobs only run when the main loop pumps the job system,
+//it simply builds every chunk itself instead of deadlocking.
+void Layer::UpdateRenderChunks() noexcept {
+    debug_chunks_rebuilt_count = 0u;
+    debug_terrain_batch_stats = QuadBatcher::Stats{};
+    debug_chunk_build_time = TimeUtils::FPMilliseconds{0.0f};
+    if(IsViewChunkBoundsEmpty()) {
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const auto chunk_count = GetChunkCount();
+    m_chunks_to_build.clear();
+    for(int y = m_view_chunk_mins.y; y <= m_view_chunk_maxs.y; ++y) {
+        for(int x = m_view_chunk_mins.x; x <= m_view_chunk_maxs.x; ++x) {
+            if(m_render_chunks[static_cast<std::size_t>(x) + static_cast<std::size_t>(y) * chunk_count.x].dirty) {
+                m_chunks_to_build.push_back(IntVector2{x, y});
+            }
+        }
+    }
+    if(m_chunks_to_build.empty()) {
+        return;
+    }
+    //Clearing touches the pool's bookkeeping, so it happens here rather than on the workers.
+    for(const auto& chunk_coords : m_chunks_to_build) {
+        m_builder_pool.Clear(m_render_chunks[static_cast<std::size_t>(chunk_coords.x) + static_cast<std::size_t>(chunk_coords.y) * chunk_count.x].builder);
+    }
+    //Corners on chunk borders are shared, so all corner light is computed here before any worker reads it.
+    for(const auto& chunk_coords : m_chunks_to_build) {
+        const auto [mins, maxs] = GetChunkTileBounds(chunk_coords);
+        CalculateCornerLight(mins, maxs);
+    }
+    if(parallel_chunk_builds && g_theJobSystem && m_chunks_to_build.size() > 1u) {
+        const auto total = m_chunks_to_build.size();
+        auto progress = std::make_shared<ChunkBuildProgress>();
+        const auto build_claimed_chunks = [this, progress, total]() {
+            for(auto i = progress->next.fetch_add(1u); i < total; i = progress->next.fetch_add(1u)) {
+                BuildRenderChunk(m_chunks_to_build[i]);
+                if(progress->finished.fetch_add(1u) + 1u == total) {
+                    progress->finished.notify_all();
+                }
+            }
+        };
+        const auto job_count = (std::min)(total - 1u, static_cast<std::size_t>((std::max)(1u, std::thread::hardware_concurrency())));
+        for(auto job = std::size_t{0u}; job != job_count; ++job) {
+            g_theJobSystem->Run(JobType::Generic, [build_claimed_chunks](void* /*user_data*/) { build_claimed_chunks(); }, nullptr);
+        }
+        build_claimed_chunks();
+        for(auto finished = progress->finished.load(); finished != total; finished = progress->finished.load()) {
+            progress->finished.wait(finished);
+        }
+    } else {
+        for(const auto& chunk_coords : m_chunks_to_build) {
+            BuildRenderChunk(chunk_coords);
+        }
+    }
+    for(const auto& chunk_coords : m_chunks_to_build) {
+        debug_terrain_batch_stats += m_render_chunks[static_cast<std::size_t>(chunk_coords.x) + static_cast<std::size_t>(chunk_coords.y) * chunk_count.x].batcher.GetStats();
+    }
+    debug_chunks_rebuilt_count = m_chunks_to_build.size();
+    debug_chunk_build_time = TimeUtils::FPMilliseconds{std::chrono::steady_clock::now() - start};
+}
+
+//Runs on a worker when chunks are built in parallel. Reads shared layer state and writes only this chunk.
+void Layer::BuildRenderChunk(const IntVector2& chunk_coords) noexcept {
+    auto& chunk = m_render_chunks[static_cast<std::size_t>(chunk_coords.x) + static_cast<std::size_t>(chunk_coords.y) * GetChunkCount().x];
+    const auto [mins, maxs] = GetChunkTileBounds(chunk_coords);
+    chunk.batcher.Clear();
+    chunk.animated_tiles.clear();
+    for(int y = mins.y; y <= maxs.y; ++y) {
+        for(int x = mins.x; x <= maxs.x; ++x) {
+            const auto index = GetTileIndex(static_cast<std::size_t>(x), static_cast<std::size_t>(y));
+            if(m_visibility_states[index] != VisibilityState::Visible) {
+                continue;
+            }
+            const auto* tile = GetTile(index);
+            if(IsTileAnimated(tile)) {
+                chunk.animated_tiles.push_back(index);
+            }
+            AppendToMesh(chunk.batcher, tile);
+        }
+    }
+    chunk.batcher.Flush(m_builder_pool.Get(chunk.builder));
+    chunk.dirty = false;
+}
+
+//Quads are collected in the batcher and flushed as one draw range per material within each
+//draw order, so features, items, actors and equipment keep their layering.
+void Layer::BuildDynamicMesh() noexcept {
+    m_builder_pool.Clear(m_dynamic_mesh_builder);
+    m_dynamic_batcher.Clear();
+    if(!IsViewChunkBoundsEmpty()) {
+        for(const auto index : m_viewable_tiles) {
+            if(m_visibility_states[index] == VisibilityState::Visible) {
+                AppendEntitiesToMesh(m_dynamic_batcher, GetTile(index));
+            }
+        }
     }
+    m_dynamic_batcher.Flush(m_builder_pool.Get(m_dynamic_mesh_builder));
+    debug_dynamic_batch_stats = m_dynamic_batcher.GetStats();
 }
 
-const Tile* Layer::GetNeighbor(const NeighborDirection& direction) {
-    switch(direction) {
-    case NeighborDirection::Self:
-        return GetNeighbor(IntVector2::Zero);
-    case NeighborDirection::East:
-        return GetNeighbor(IntVector2::X_Axis);
-    case NeighborDirection::NorthEast:
-        return GetNeighbor(IntVector2{1, -1});
-    case NeighborDirection::North:
-        return GetNeighbor(-IntVector2::Y_Axis);
-    case NeighborDirection::NorthWest:
-        return GetNeighbor(-IntVector2::XY_Axis);
-    case NeighborDirection::West:
-        return GetNeighbor(-IntVector2::X_Axis);
-    case NeighborDirection::SouthWest:
-        return GetNeighbor(IntVector2{-1, 1});
-    case NeighborDirection::South:
-        return GetNeighbor(IntVector2::Y_Axis);
-    case NeighborDirection::SouthEast:
-        return GetNeighbor(IntVector2::XY_Axis);
-    default:
+//Animated tile sprites are shared by their definition and advanced once per frame by the
+//map's animation scheduler. A chunk is rebuilt only when one of its animated tiles moved to a new frame.
+void Layer::DirtyAnimatedChunks() noexcept {
+    if(m_map == nullptr || IsViewChunkBoundsEmpty()) {
+        return;
+    }
+    const auto& scheduler = m_map->GetAnimationScheduler();
+    if(!scheduler.HasAnyFrameChanged()) {
+        return;
+    }
+    const auto chunk_count = GetChunkCount();
+    for(int y = m_view_chunk_mins.y; y <= m_view_chunk_maxs.y; ++y) {
+        for(int x = m_view_chunk_mins.x; x <= m_view_chunk_maxs.x; ++x) {
+            auto& chunk = m_render_chunks[static_cast<std::size_t>(x) + static_cast<std::size_t>(y) * chunk_count.x];
+            if(chunk.dirty) {
+                continue;
+            }
+            for(const auto index : chunk.animated_tiles) {
+                if(const auto* frame = scheduler.GetTileFrame(m_tiles[index].GetDefinitionId()); frame && frame->changed) {
+                    chunk.dirty = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void Layer::UpdateTileInstances() noexcept {
+    m_tile_instances.Clear();
+    if(build_tile_instances) {
+        const auto start = std::chrono::steady_clock::now();
+        BuildTileInstances(m_tile_instances);
+        debug_tile_instance_build_time = TimeUtils::FPMilliseconds{std::chrono::steady_clock::now() - start};
+    } else {
+        debug_tile_instance_build_time = TimeUtils::FPMilliseconds{0.0f};
+    }
+    debug_tile_instance_count = m_tile_instances.size();
+    debug_tile_instance_bytes = m_tile_instances.GetByteSize();
+}
+
+void Layer::UpdateTileVertices() noexcept {
+    m_tile_vertices.Clear();
+    if(build_tile_vertices) {
+        const auto start = std::chrono::steady_clock::now();
+        BuildTileVertices(m_tile_vertices);
+        debug_tile_vertex_build_time = TimeUtils::FPMilliseconds{std::chrono::steady_clock::now() - start};
+    } else {
+        debug_tile_vertex_build_time = TimeUtils::FPMilliseconds{0.0f};
+    }
+    debug_tile_vertex_quad_count = m_tile_vertices.GetQuadCount();
+    debug_tile_vertex_bytes = m_tile_vertices.GetByteSize();
+}
+
+//Calls back with the coordinates and current sprite texture coordinates of every visible terrain
+//tile in the chunks in view, animated or not. Needs only the tiles and visibility, so it runs without a renderer.
+template<typename Callback>
+void Layer::ForEachVisibleTerrainTile(Callback&& callback) const noexcept {
+    if(IsViewChunkBoundsEmpty()) {
+        return;
+    }
+    const auto mins = GetChunkTileBounds(m_view_chunk_mins).first;
+    const auto maxs = GetChunkTileBounds(m_view_chunk_maxs).second;
+    for(int y = mins.y; y <= maxs.y; ++y) {
+        for(int x = mins.x; x <= maxs.x; ++x) {
+            const auto index = GetTileIndex(static_cast<std::size_t>(x), static_cast<std::size_t>(y));
+            if(m_visibility_states[index] != VisibilityState::Visible) {
+                continue;
+            }
+            const auto* tile = GetTile(index);
+            if(!m_showInvisibleTiles && tile->IsInvisible()) {
+                continue;
+            }
+            if(const auto* frame = GetTileFrame(tile); frame != nullptr) {
+                callback(IntVector2{x, y}, frame->uv_coords);
+            }
+        }
+    }
+}
+
+//Appends every visible terrain tile in view in the compact instance format.
+void Layer::BuildTileInstances(TileInstanceStream& stream) const noexcept {
+    ForEachVisibleTerrainTile([this, &stream](const IntVector2& tile_coords, const AABB2& uv_coords) {
+        const auto corner_lights = std::array<uint32_t, 4>{
+            GetCornerLightValue(tile_coords.x, tile_coords.y + 1)
+            , GetCornerLightValue(tile_coords.x, tile_coords.y)
+            , GetCornerLightValue(tile_coords.x + 1, tile_coords.y)
+            , GetCornerLightValue(tile_coords.x + 1, tile_coords.y + 1)
+        };
+        stream.Append(tile_coords, uv_coords, corner_lights);
+    });
+}
+
+//Appends every visible terrain tile in view as quantized quads, lit by the same light color table as the chunk meshes.
+void Layer::BuildTileVertices(TileVertexStream& stream) const noexcept {
+    ForEachVisibleTerrainTile([this, &stream](const IntVector2& tile_coords, const AABB2& uv_coords) {
+        const auto corner_colors = std::array<Rgba, 4>{
+            m_light_colors[GetCornerLightValue(tile_coords.x, tile_coords.y + 1)]
+            , m_light_colors[GetCornerLightValue(tile_coords.x, tile_coords.y)]
+            , m_light_colors[GetCornerLightValue(tile_coords.x + 1, tile_coords.y)]
+            , m_light_colors[GetCornerLightValue(tile_coords.x + 1, tile_coords.y + 1)]
+        };
+        stream.AppendQuad(tile_coords, uv_coords, corner_colors);
+    });
+}
+
+const TileVertexStream& Layer::GetTileVertices() const noexcept {
+    return m_tile_vertices;
+}
+
+const TileInstanceStream& Layer::GetTileInstances() const noexcept {
+    return m_tile_instances;
+}
+
+bool Layer::IsTileAnimated(const Tile* const tile) const noexcept {
+    if(const auto* def = tile->GetDefinition()) {
+        return def->is_animated;
+    }
+    return false;
+}
+
+const AnimationScheduler::SpriteFrame* Layer::GetTileFrame(const Tile* const tile) const noexcept {
+    if(m_map == nullptr) {
         return nullptr;
     }
+    return m_map->GetAnimationScheduler().GetTileFrame(tile->GetDefinitionId());
 }
 
-const Tile* Layer::GetNeighbor(const IntVector2& direction) {
-    return GetTile(direction.x, direction.y);
+void Layer::DirtyStaticLight() noexcept {
+    m_staticLightDirty = true;
 }
 
-void Layer::DirtyMesh() noexcept {
-    m_meshDirty = true;
+bool Layer::IsStaticLightDirty() const noexcept {
+    return m_staticLightDirty;
+}
+
+uint32_t Layer::GetStaticLightValue(std::size_t index) const noexcept {
+    if(index >= m_static_light.size()) {
+        return uint32_t{0u};
+    }
+    return m_static_light[index];
+}
+
+void Layer::SetStaticLightPlane(std::vector<uint8_t>&& plane) noexcept {
+    m_static_light = std::move(plane);
+    m_staticLightDirty = false;
 }
 
 std::vector<Tile>::const_iterator Layer::cbegin() const noexcept {
@@ -117,8 +445,9 @@ std::vector<Tile>::iterator Layer::end() noexcept {
     return m_tiles.end();
 }
 
+//The dynamic stream: features, items, actors and the cursor. Rebuilt every frame.
 const Mesh::Builder& Layer::GetMeshBuilder() const noexcept {
-    return m_mesh_builder;
+    return m_builder_pool.Get(m_dynamic_mesh_builder);
 }
 
 Mesh::Builder& Layer::GetMeshBuilder() noexcept {
@@ -129,31 +458,43 @@ void Layer::DebugShowInvisibleTiles(bool show) noexcept {
     m_showInvisibleTiles = show;
 }
 
-void Layer::AppendToMesh(const Tile* const tile) noexcept {
+//Terrain only. Features, items and actors belong to the dynamic stream; see AppendEntitiesToMesh.
+void Layer::AppendToMesh(QuadBatcher& batcher, const Tile* const tile) noexcept {
     if(!m_showInvisibleTiles && tile->IsInvisible()) {
         return;
     }
-    if(const auto* sprite = [&]()->AnimatedSprite* { if(auto* def = TileDefinition::GetTileDefinitionByName(tile->GetType())) { return def->GetSprite(); } else { return nullptr; } }(); sprite == nullptr) {
-        return;
-    } else {
-        const auto& coords = sprite->GetCurrentTexCoords();
+    if(const auto* frame = GetTileFrame(tile); frame != nullptr) {
         const auto& tile_coords = tile->GetCoords();
-        if(auto* material = sprite->GetMaterial()) {
-            AppendToMesh(tile_coords, coords, tile->GetLightValue(), material);
-        }
-        if(tile->feature) {
-            AppendToMesh(tile->feature);
-        }
-        if(tile->HasInventory()) {
-            AppendToMesh(tile->inventory.get(), tile->GetCoords());
-        }
-        if(tile->actor) {
-            AppendToMesh(tile->actor);
-        }
+        const auto corner_colors = std::array<Rgba, 4>{
+            m_light_colors[GetCornerLightValue(tile_coords.x, tile_coords.y + 1)]
+            , m_light_colors[GetCornerLightValue(tile_coords.x, tile_coords.y)]
+            , m_light_colors[GetCornerLightValue(tile_coords.x + 1, tile_coords.y)]
+            , m_light_colors[GetCornerLightValue(tile_coords.x + 1, tile_coords.y + 1)]
+        };
+        AppendToMesh(batcher, tile_coords, frame->uv_coords, corner_colors, frame->material);
+    }
+}
+
+void Layer::AppendEntitiesToMesh(QuadBatcher& batcher, const Tile* const tile) noexcept {
+    if(!m_showInvisibleTiles && tile->IsInvisible()) {
+        return;
+    }
+    if(tile->feature) {
+        batcher.SetDrawOrder(QuadBatcher::DrawOrder::Feature);
+        AppendToMesh(batcher, tile->feature);
+    }
+    if(tile->HasInventory()) {
+        batcher.SetDrawOrder(QuadBatcher::DrawOrder::Item);
+        AppendToMesh(batcher, tile->inventory.get(), tile->GetCoords());
+    }
+    if(tile->actor) {
+        batcher.SetDrawOrder(QuadBatcher::DrawOrder::Actor);
+        AppendToMesh(batcher, tile->actor);
     }
 }
 
-void Layer::AppendToMesh(const Entity* const entity) noexcept {
+//Equipment sets its own draw order; the entity's order is restored around it.
+void Layer::AppendToMesh(QuadBatcher& batcher, const Entity* const entity) noexcept {
     if(!entity || (entity && !entity->sprite) || entity->IsInvisible()) {
         return;
     }
@@ -164,71 +505,47 @@ void Layer::AppendToMesh(const Entity* const entity) noexcept {
         auto tvalue = entity->tile->GetLightValue();
         return (std::max)(evalue, tvalue);
     }(); //IIIL
-    entity->AddVertsForCapeEquipment();
-    AppendToMesh(position, coords, entity_light_value, entity->sprite->GetMaterial());
-    entity->AddVertsForEquipment();
+    const auto entity_order = batcher.GetDrawOrder();
+    entity->AddVertsForCapeEquipment(batcher);
+    batcher.SetDrawOrder(entity_order);
+    AppendToMesh(batcher, position, coords, entity_light_value, entity->sprite->GetMaterial());
+    entity->AddVertsForEquipment(batcher);
+    batcher.SetDrawOrder(entity_order);
+}
+
+void Layer::AppendToMesh(QuadBatcher& batcher, const IntVector2& tile_coords, const AABB2& uv_coords, const uint32_t light_value, Material* material) noexcept {
+    const auto& light_color = m_light_colors[(std::min)(light_value, static_cast<uint32_t>(max_light_value))];
+    AppendToMesh(batcher, tile_coords, uv_coords, std::array<Rgba, 4>{light_color, light_color, light_color, light_color}, material);
 }
 
-void Layer::AppendToMesh(const IntVector2& tile_coords, const AABB2& uv_coords, const uint32_t light_value, Material* material) noexcept {
+//Corner colors are in bottom-left, top-left, top-right, bottom-right order.
+void Layer::AppendToMesh(QuadBatcher& batcher, const IntVector2& tile_coords, const AABB2& uv_coords, const std::array<Rgba, 4>& corner_colors, Material* material) noexcept {
     const auto [vert_bl, vert_tl, vert_tr, vert_br] = VertsFromTileCoords(tile_coords);
     const auto [tx_bl, tx_tl, tx_tr, tx_br] = UVsFromUVCoords(uv_coords);
-
     const float z = static_cast<float>(z_index);
-    const Rgba layer_color = color;
-
-    auto& builder = GetMeshBuilder();
-    const auto newColor = [&]() {
-        auto clr = layer_color != color && color != Rgba::White ? color : layer_color;
-        clr.ScaleRGB(MathUtils::RangeMap(static_cast<float>(light_value), static_cast<float>(min_light_value), static_cast<float>(max_light_value), min_light_scale, max_light_scale));
-        return clr;
-    }(); //IIIL
-    const auto normal = -Vector3::Z_Axis;
-
-    const auto [nc, ec, sc, wc] = [this, newColor]() {
-        auto northColor = newColor;
-        if (const auto n = GetNeighbor(Layer::NeighborDirection::North); n && n->GetLightValue() > 0u) {
-            northColor.ScaleRGB(MathUtils::RangeMap(static_cast<float>(n->GetLightValue()), static_cast<float>(min_light_value), static_cast<float>(max_light_value), min_light_scale, max_light_scale));
-        }
-        auto eastColor = newColor;
-        if (const auto e = GetNeighbor(Layer::NeighborDirection::East); e && e->GetLightValue() > 0u) {
-            eastColor.ScaleRGB(MathUtils::RangeMap(static_cast<float>(e->GetLightValue()), static_cast<float>(min_light_value), static_cast<float>(max_light_value), min_light_scale, max_light_scale));
-        }
-        auto southColor = newColor;
-        if (const auto s = GetNeighbor(Layer::NeighborDirection::South); s && s->GetLightValue() > 0u) {
-            southColor.ScaleRGB(MathUtils::RangeMap(static_cast<float>(s->GetLightValue()), static_cast<float>(min_light_value), static_cast<float>(max_light_value), min_light_scale, max_light_scale));
-        }
-        auto westColor = newColor;
-        if (const auto w = GetNeighbor(Layer::NeighborDirection::West); w && w->GetLightValue() > 0u) {
-            westColor.ScaleRGB(MathUtils::RangeMap(static_cast<float>(w->GetLightValue()), static_cast<float>(min_light_value), static_cast<float>(max_light_value), min_light_scale, max_light_scale));
-        }
-        return std::make_tuple(northColor, eastColor, southColor, westColor);
-    }(); //IIIL
-
-    builder.Begin(PrimitiveType::Triangles);
-    builder.SetNormal(normal);
-
-    builder.SetUV(tx_bl);
-    builder.SetColor(sc < wc ? wc : sc);
-    builder.AddVertex(Vector3{vert_bl, z});
-
-    builder.SetUV(tx_tl);
-    builder.SetColor(nc < wc ? wc : nc);
-    builder.AddVertex(Vector3{vert_tl, z});
-
-    builder.SetUV(tx_tr);
-    builder.SetColor(nc < ec ? ec : nc);
-    builder.AddVertex(Vector3{vert_tr, z});
-
-    builder.SetUV(tx_br);
-    builder.SetColor(sc < ec ? ec : sc);
-    builder.AddVertex(Vector3{vert_br, z});
-
-    builder.AddIndicies(Mesh::Builder::Primitive::Quad);
+    batcher.AddQuad(std::array<Vector3, 4>{Vector3{vert_bl, z}, Vector3{vert_tl, z}, Vector3{vert_tr, z}, Vector3{vert_br, z}}, std::array<Vector2, 4>{tx_bl, tx_tl, tx_tr, tx_br}, corner_colors, material);
+}
 
-    builder.End(material);
+//Remembered tiles show only their terrain and feature at a fixed dim light.
+//Nothing in them animates, so the result stays valid until the remembered set changes.
+void Layer::AppendRememberedToMesh(QuadBatcher& batcher, const Tile* const tile) noexcept {
+    if(!m_showInvisibleTiles && tile->IsInvisible()) {
+        return;
+    }
+    const auto& light_color = m_light_colors[remembered_light_value];
+    const auto corner_colors = std::array<Rgba, 4>{light_color, light_color, light_color, light_color};
+    const auto& tile_coords = tile->GetCoords();
+    if(const auto* frame = GetTileFrame(tile); frame != nullptr) {
+        batcher.SetDrawOrder(QuadBatcher::DrawOrder::Terrain);
+        AppendToMesh(batcher, tile_coords, frame->uv_coords, corner_colors, frame->material);
+    }
+    if(const auto* feature = tile->feature; feature && feature->sprite && !feature->IsInvisible()) {
+        batcher.SetDrawOrder(QuadBatcher::DrawOrder::Feature);
+        AppendToMesh(batcher, tile_coords, feature->sprite->GetCurrentTexCoords(), corner_colors, feature->sprite->GetMaterial());
+    }
 }
 
-void Layer::AppendToMesh(const Item* const item, const IntVector2& tile_coords) noexcept {
+void Layer::AppendToMesh(QuadBatcher& batcher, const Item* const item, const IntVector2& tile_coords) noexcept {
     if(item == nullptr) {
         return;
     }
@@ -248,13 +565,13 @@ void Layer::AppendToMesh(const Item* const item, const IntVector2& tile_coords)
         }
         return uint32_t{0u};
     }();
-    AppendToMesh(tile_coords, uvs, light_value, material);
+    AppendToMesh(batcher, tile_coords, uvs, light_value, material);
 }
 
-void Layer::AppendToMesh(const Inventory* const inventory, const IntVector2& tile_coords) noexcept {
-    if(inventory && !inventory->empty()) {
-        if(const auto* const item = Item::GetItem("chest"); item != nullptr) {
-            AppendToMesh(item, tile_coords);
+void Layer::AppendToMesh(QuadBatcher& batcher, const Inventory* const inventory, const IntVector2& tile_coords) noexcept {
+    if(inventory && !inventory->empty() && m_map) {
+        if(const auto* const item = m_map->GetAnimationScheduler().GetChestItem(); item != nullptr) {
+            AppendToMesh(batcher, item, tile_coords);
         }
     }
 }
@@ -315,6 +632,7 @@ bool Layer::LoadFromImage(const Image& img) {
     int tile_y = 0;
     for(auto& t : m_tiles) {
         t.layer = this;
+        t.ResolveDefinition();
         t.color = img.GetTexel(IntVector2{tile_x, tile_y});
         t.SetCoords(tile_x++, tile_y);
         tile_x %= layer_width;
@@ -322,6 +640,7 @@ bool Layer::LoadFromImage(const Image& img) {
             ++tile_y;
         }
     }
+    InitializeBitGrids();
     return true;
 }
 
@@ -335,15 +654,16 @@ void Layer::InitializeTiles(const std::size_t layer_width, const std::size_t lay
             tile_iter->ChangeTypeFromGlyph(c);
             const std::size_t index = std::distance(std::begin(m_tiles), tile_iter);
             tile_iter->SetCoords(static_cast<int>(index % layer_width), static_cast<int>(index / layer_width));
-            if(auto* def = TileDefinition::GetTileDefinitionByName(tile_iter->GetType()); def && def->is_entrance) {
+            if(auto* def = tile_iter->GetDefinition(); def && def->is_entrance) {
                 tile_iter->SetEntrance();
             }
-            if(auto* def = TileDefinition::GetTileDefinitionByName(tile_iter->GetType()); def && def->is_exit) {
+            if(auto* def = tile_iter->GetDefinition(); def && def->is_exit) {
                 tile_iter->SetExit();
             }
             ++tile_iter;
         }
     }
+    InitializeBitGrids();
 }
 
 std::size_t Layer::NormalizeLayerRows(std::vector<std::string>& glyph_strings) {
@@ -405,7 +725,16 @@ void Layer::SetModelViewProjectionBounds() const {
 
 void Layer::RenderTiles() const {
     g_theRenderer->SetModelMatrix(Matrix4::I);
-    Mesh::Render(m_mesh_builder);
+    Mesh::Render(m_builder_pool.Get(m_remembered_mesh_builder));
+    if(!IsViewChunkBoundsEmpty()) {
+        const auto chunk_count = GetChunkCount();
+        for(int y = m_view_chunk_mins.y; y <= m_view_chunk_maxs.y; ++y) {
+            for(int x = m_view_chunk_mins.x; x <= m_view_chunk_maxs.x; ++x) {
+                Mesh::Render(m_builder_pool.Get(m_render_chunks[static_cast<std::size_t>(x) + static_cast<std::size_t>(y) * chunk_count.x].builder));
+            }
+        }
+    }
+    Mesh::Render(m_builder_pool.Get(m_dynamic_mesh_builder));
 }
 
 void Layer::DebugRenderTiles() const {
@@ -421,81 +750,298 @@ void Layer::DebugRenderTiles() const {
     }
 }
 
-void Layer::UpdateTiles(TimeUtils::FPSeconds deltaSeconds) {
-    debug_tiles_in_view_count = 0;
-    debug_visible_tiles_in_view_count = 0;
-    for (auto& tile : m_tiles) {
-        tile.ClearCanSee();
-    }
-    const auto viewableTiles = [this]() {
-        const auto view_area = CalcCullBounds(m_map->cameraController.GetCamera().GetPosition());
-        const auto dims = view_area.CalcDimensions();
-        const auto width = static_cast<std::size_t>(dims.x);
-        const auto height = static_cast<std::size_t>(dims.y);
-        std::vector<Tile*> results;
-        results.reserve(width * height);
-        for(int x = static_cast<int>(view_area.mins.x); x <= view_area.maxs.x; ++x) {
-            if(x >= tileDimensions.x || x < 0) {
-                continue;
+void Layer::UpdateTiles(TimeUtils::FPSeconds /*deltaSeconds*/) {
+    const auto view_area = CalcCullBounds(m_map->cameraController.GetCamera().GetPosition());
+    {
+        const auto view_mins = IntVector2{(std::max)(0, static_cast<int>(view_area.mins.x)), (std::max)(0, static_cast<int>(view_area.mins.y))};
+        const auto view_maxs = IntVector2{(std::min)(tileDimensions.x - 1, static_cast<int>(view_area.maxs.x)), (std::min)(tileDimensions.y - 1, static_cast<int>(view_area.maxs.y))};
+        if(view_mins != m_mesh_bounds_mins || view_maxs != m_mesh_bounds_maxs) {
+            UpdateViewableTiles(view_mins, view_maxs);
+            m_mesh_bounds_mins = view_mins;
+            m_mesh_bounds_maxs = view_maxs;
+            const auto old_chunk_mins = m_view_chunk_mins;
+            const auto old_chunk_maxs = m_view_chunk_maxs;
+            UpdateViewChunkBounds();
+            if(old_chunk_mins != m_view_chunk_mins || old_chunk_maxs != m_view_chunk_maxs) {
+                m_rememberedMeshDirty = true;
             }
-            for(int y = static_cast<int>(view_area.mins.y); y <= view_area.maxs.y; ++y) {
-                if(y >= tileDimensions.y || y < 0) {
-                    continue;
-                }
-                if(auto* tile = GetTile(x, y); tile != nullptr) {
-                    results.push_back(tile);
+        }
+    }
+    InitializeRenderChunks();
+    UpdateChunkBuilders();
+    UpdateVisibility();
+    UpdateFogOfWar();
+    DirtyAnimatedChunks();
+    CalculateLightColorTable();
+    if(m_rememberedMeshDirty) {
+        BuildRememberedMesh();
+    }
+    UpdateRenderChunks();
+    BuildDynamicMesh();
+    UpdateTileInstances();
+    UpdateTileVertices();
+    debug_builder_pool_stats = m_builder_pool.GetStats();
+    debug_tiles_in_view_count = m_viewable_tiles.size();
+    debug_visible_tiles_in_view_count = 0;
+    //UpdateFogOfWar merges visible into explored first, so every visible tile counted here is also explored.
+    for(const auto index : m_viewable_tiles) {
+        if(m_visibility_states[index] == VisibilityState::Visible) {
+            ++debug_visible_tiles_in_view_count;
+        }
+    }
+}
+
+//Moves the viewable set from the current mesh bounds to the new ones. Tiles in rows and
+//columns that scrolled out are dropped and only the rows and columns that scrolled in are
+//appended, so a one-tile camera step touches one row or column instead of the whole view.
+void Layer::UpdateViewableTiles(const IntVector2& view_mins, const IntVector2& view_maxs) noexcept {
+    const auto old_mins = m_mesh_bounds_mins;
+    const auto old_maxs = m_mesh_bounds_maxs;
+    const auto tile_width = static_cast<std::size_t>(tileDimensions.x);
+    std::erase_if(m_viewable_tiles, [&](const std::size_t index) {
+        const auto x = static_cast<int>(index % tile_width);
+        const auto y = static_cast<int>(index / tile_width);
+        return x < view_mins.x || x > view_maxs.x || y < view_mins.y || y > view_maxs.y;
+    });
+    for(int y = view_mins.y; y <= view_maxs.y; ++y) {
+        if(y < old_mins.y || y > old_maxs.y || old_maxs.x < old_mins.x) {
+            AppendViewableSpan(y, view_mins.x, view_maxs.x);
+            continue;
+        }
+        AppendViewableSpan(y, view_mins.x, (std::min)(view_maxs.x, old_mins.x - 1));
+        AppendViewableSpan(y, (std::max)(view_mins.x, old_maxs.x + 1), view_maxs.x);
+    }
+}
+
+void Layer::AppendViewableSpan(int y, int x_first, int x_last) noexcept {
+    for(int x = x_first; x <= x_last; ++x) {
+        m_viewable_tiles.push_back(GetTileIndex(static_cast<std::size_t>(x), static_cast<std::size_t>(y)));
+    }
+}
+
+//Folds this frame's visible tiles into the explored set and classifies every tile in the chunks
+//in view. Any change dirties the tile's chunk; only a tile entering or leaving the remembered
+//state invalidates the remembered mesh.
+void Layer::UpdateFogOfWar() noexcept {
+    m_explored_tiles.Merge(m_visible_tiles);
+    m_visibility_states.resize(m_tiles.size(), VisibilityState::Unseen);
+    if(IsViewChunkBoundsEmpty()) {
+        return;
+    }
+    const auto chunk_count = GetChunkCount();
+    for(int chunk_y = m_view_chunk_mins.y; chunk_y <= m_view_chunk_maxs.y; ++chunk_y) {
+        for(int chunk_x = m_view_chunk_mins.x; chunk_x <= m_view_chunk_maxs.x; ++chunk_x) {
+            auto& chunk = m_render_chunks[static_cast<std::size_t>(chunk_x) + static_cast<std::size_t>(chunk_y) * chunk_count.x];
+            const auto [mins, maxs] = GetChunkTileBounds(IntVector2{chunk_x, chunk_y});
+            for(int y = mins.y; y <= maxs.y; ++y) {
+                for(int x = mins.x; x <= maxs.x; ++x) {
+                    const auto index = GetTileIndex(static_cast<std::size_t>(x), static_cast<std::size_t>(y));
+                    const auto state = m_visible_tiles.Test(index) ? VisibilityState::Visible : (m_explored_tiles.Test(index) ? VisibilityState::Remembered : VisibilityState::Unseen);
+                    auto& previous = m_visibility_states[index];
+                    if(previous == state) {
+                        continue;
+                    }
+                    chunk.dirty = true;
+                    if(previous == VisibilityState::Remembered || state == VisibilityState::Remembered) {
+                        m_rememberedMeshDirty = true;
+                    }
+                    previous = state;
                 }
             }
         }
-        results.shrink_to_fit();
-        return results;
-    }();
-    for(auto& tile : viewableTiles) {
-        if(tile->GetLightValue()) {
-            tile->SetCanSee();
+    }
+}
+
+void Layer::BuildRememberedMesh() noexcept {
+    m_builder_pool.Clear(m_remembered_mesh_builder);
+    m_remembered_batcher.Clear();
+    m_rememberedMeshDirty = false;
+    if(IsViewChunkBoundsEmpty()) {
+        return;
+    }
+    const auto mins = GetChunkTileBounds(m_view_chunk_mins).first;
+    const auto maxs = GetChunkTileBounds(m_view_chunk_maxs).second;
+    for(int y = mins.y; y <= maxs.y; ++y) {
+        for(int x = mins.x; x <= maxs.x; ++x) {
+            const auto index = GetTileIndex(static_cast<std::size_t>(x), static_cast<std::size_t>(y));
+            if(m_visibility_states[index] == VisibilityState::Remembered) {
+                AppendRememberedToMesh(m_remembered_batcher, GetTile(index));
+            }
         }
     }
-    const auto& visibleTiles = [&]()->std::vector<Tile*> {
-        if(m_map) {
-            if(m_map->player && m_map->player->tile) {
-                return m_map->GetVisibleTilesWithinDistance(*m_map->player->tile, m_map->player->GetLightValue());
-            } else {
-                if(const auto* layer = m_map->GetLayer(0); layer != nullptr) {
-                    if(Tile* t = m_map->GetTile(layer->tileDimensions.x / 2, layer->tileDimensions.y / 2, 0); t != nullptr) {
-                        return m_map->GetVisibleTilesWithinDistance(*t, 1.0f + (std::max)(layer->tileDimensions.x, layer->tileDimensions.y));
-                    }
+    m_remembered_batcher.Flush(m_builder_pool.Get(m_remembered_mesh_builder));
+}
+
+//Each corner takes the rounded average of the open tiles that share it, so light
+//fades smoothly across floors and spills onto the faces of adjacent walls.
+//Corners touching only opaque tiles take the brightest of them.
+//Corners with no visible tile around them are skipped.
+void Layer::CalculateCornerLight(const IntVector2& mins, const IntVector2& maxs) noexcept {
+    const auto corner_width = static_cast<std::size_t>(tileDimensions.x) + 1u;
+    m_corner_light.resize(corner_width * (static_cast<std::size_t>(tileDimensions.y) + 1u));
+    for(int y = mins.y; y <= maxs.y + 1; ++y) {
+        for(int x = mins.x; x <= maxs.x + 1; ++x) {
+            uint32_t open_total = 0u;
+            uint32_t open_count = 0u;
+            uint32_t opaque_max = 0u;
+            bool touches_visible = false;
+            for(const auto& offset : {IntVector2{-1, -1}, IntVector2{0, -1}, IntVector2{-1, 0}, IntVector2{0, 0}}) {
+                const auto tile_x = x + offset.x;
+                const auto tile_y = y + offset.y;
+                if(tile_x < 0 || tile_y < 0 || tile_x >= tileDimensions.x || tile_y >= tileDimensions.y) {
+                    continue;
+                }
+                const auto* tile = GetTile(static_cast<std::size_t>(tile_x), static_cast<std::size_t>(tile_y));
+                touches_visible |= GetVisibilityState(tile->GetIndexFromCoords()) == VisibilityState::Visible;
+                if(tile->IsOpaque()) {
+                    opaque_max = (std::max)(opaque_max, tile->GetLightValue());
+                } else {
+                    open_total += tile->GetLightValue();
+                    ++open_count;
                 }
             }
+            //Only corners of visible tiles are ever drawn with per-corner light.
+            if(!touches_visible) {
+                continue;
+            }
+            const auto value = open_count ? (open_total + open_count / 2u) / open_count : opaque_max;
+            m_corner_light[static_cast<std::size_t>(x) + static_cast<std::size_t>(y) * corner_width] = static_cast<uint8_t>(value);
         }
-        return {};
-    }();
-    for(auto& tile : visibleTiles) {
-        tile->SetCanSee();
-        tile->SetHaveSeen();
-    }
-    if(m_meshNeedsRebuild) {
-        for(auto& tile : viewableTiles) {
-            ++debug_tiles_in_view_count;
-            if(tile->CanSee()) {
-                ++debug_visible_tiles_in_view_count;
+    }
+}
+
+void Layer::CalculateLightColorTable() noexcept {
+    for(auto light_value = std::size_t{0u}; light_value != m_light_colors.size(); ++light_value) {
+        auto light_color = color;
+        light_color.ScaleRGB(MathUtils::RangeMap(static_cast<float>(light_value), static_cast<float>(min_light_value), static_cast<float>(max_light_value), min_light_scale, max_light_scale));
+        m_light_colors[light_value] = light_color;
+    }
+}
+
+uint32_t Layer::GetCornerLightValue(int x, int y) const noexcept {
+    const auto index = static_cast<std::size_t>(x) + static_cast<std::size_t>(y) * (static_cast<std::size_t>(tileDimensions.x) + 1u);
+    if(x < 0 || y < 0 || index >= m_corner_light.size()) {
+        return uint32_t{0u};
+    }
+    return m_corner_light[index];
+}
+
+void Layer::UpdateVisibility() noexcept {
+    if(m_map && m_map->player && m_map->player->tile) {
+        //The field of view is the only source of visibility. Light only decides whether a tile inside it can be made out.
+        const auto origin = m_map->player->tile->GetCoords();
+        const auto mark_visible = [this, &origin](const IntVector2& coords) {
+            if(const auto* tile = GetTile(static_cast<std::size_t>(coords.x), static_cast<std::size_t>(coords.y)); tile && !tile->IsInvisible() && (tile->GetLightValue() || coords == origin)) {
+                m_visible_tiles.Set(coords);
+            }
+        };
+        const auto is_opaque = [this](const IntVector2& coords) {
+            return m_opaque_tiles.Test(coords);
+        };
+        FieldOfView::Calculate(m_map->player->GetFieldOfViewMode(), origin, m_map->player->GetSightRadius(), tileDimensions, is_opaque, mark_visible);
+    } else {
+        //Without a player everything in view is visible.
+        for(const auto index : m_viewable_tiles) {
+            if(!m_tiles[index].IsInvisible()) {
+                m_visible_tiles.Set(index);
             }
-            AppendToMesh(tile);
         }
-        m_meshNeedsRebuild = false;
     }
-    for(auto& tile : viewableTiles) {
-        if(tile->GetLightValue()) {
-            tile->Update(deltaSeconds);
+}
+
+void Layer::InitializeBitGrids() noexcept {
+    m_visible_tiles.Resize(tileDimensions);
+    m_explored_tiles.Resize(tileDimensions);
+    m_opaque_tiles.Resize(tileDimensions);
+    m_visibility_states.assign(m_tiles.size(), VisibilityState::Unseen);
+    for(const auto& tile : m_tiles) {
+        if(tile.IsOpaque()) {
+            m_opaque_tiles.Set(tile.GetCoords());
         }
     }
 }
 
-void Layer::BeginFrame() {
-    for(auto& tile : m_tiles) {
-        tile.ClearCanSee();
+bool Layer::IsTileOpaque(const IntVector2& tile_coords) const noexcept {
+    return m_opaque_tiles.Test(tile_coords);
+}
+
+const BitGrid& Layer::GetOpacity() const noexcept {
+    return m_opaque_tiles;
+}
+
+void Layer::UpdateOpacityAt(const IntVector2& tile_coords) noexcept {
+    if(m_opaque_tiles.size() != m_tiles.size()) {
+        return;
+    }
+    const auto* tile = GetTile(static_cast<std::size_t>(tile_coords.x), static_cast<std::size_t>(tile_coords.y));
+    if(tile == nullptr) {
+        return;
+    }
+    const auto is_opaque = tile->IsOpaque();
+    if(m_opaque_tiles.Test(tile_coords) == is_opaque) {
+        return;
+    }
+    if(is_opaque) {
+        m_opaque_tiles.Set(tile_coords);
+    } else {
+        m_opaque_tiles.Reset(tile_coords);
+    }
+    if(m_map) {
+        m_map->OnOpacityChanged(*this, tile_coords);
     }
 }
 
+bool Layer::IsTileVisible(std::size_t index) const noexcept {
+    return m_visible_tiles.Test(index);
+}
+
+void Layer::SetTileVisible(std::size_t index) noexcept {
+    m_visible_tiles.Set(index);
+}
+
+void Layer::ClearTileVisible(std::size_t index) noexcept {
+    m_visible_tiles.Reset(index);
+}
+
+bool Layer::IsTileExplored(std::size_t index) const noexcept {
+    return m_explored_tiles.Test(index);
+}
+
+void Layer::SetTileExplored(std::size_t index) noexcept {
+    m_explored_tiles.Set(index);
+}
+
+void Layer::ClearTileExplored(std::size_t index) noexcept {
+    m_explored_tiles.Reset(index);
+}
+
+void Layer::ClearVisibility() noexcept {
+    m_visible_tiles.Clear();
+}
+
+std::span<const BitGrid::word_type> Layer::GetVisibilityBits() const noexcept {
+    return m_visible_tiles.GetWords();
+}
+
+Layer::VisibilityState Layer::GetVisibilityState(std::size_t index) const noexcept {
+    if(index >= m_visibility_states.size()) {
+        return VisibilityState::Unseen;
+    }
+    return m_visibility_states[index];
+}
+
+std::span<const Layer::VisibilityState> Layer::GetVisibilityStates() const noexcept {
+    return m_visibility_states;
+}
+
+std::span<const BitGrid::word_type> Layer::GetExploredBits() const noexcept {
+    return m_explored_tiles.GetWords();
+}
+
+void Layer::BeginFrame() {
+    ClearVisibility();
+}
+
 void Layer::Update(TimeUtils::FPSeconds deltaSeconds) {
     UpdateTiles(deltaSeconds);
 }
@@ -505,16 +1051,27 @@ void Layer::Render() const {
     RenderTiles();
 }
 
+//Submits the same builders as RenderTiles, in the same order, without touching the renderer.
+void Layer::Record(RenderRecorder& recorder) const noexcept {
+    recorder.SubmitMesh(m_builder_pool.Get(m_remembered_mesh_builder));
+    if(!IsViewChunkBoundsEmpty()) {
+        const auto chunk_count = GetChunkCount();
+        for(int y = m_view_chunk_mins.y; y <= m_view_chunk_maxs.y; ++y) {
+            for(int x = m_view_chunk_mins.x; x <= m_view_chunk_maxs.x; ++x) {
+                recorder.SubmitMesh(m_builder_pool.Get(m_render_chunks[static_cast<std::size_t>(x) + static_cast<std::size_t>(y) * chunk_count.x].builder));
+            }
+        }
+    }
+    recorder.SubmitMesh(m_builder_pool.Get(m_dynamic_mesh_builder));
+}
+
 void Layer::DebugRender() const {
     SetModelViewProjectionBounds();
     DebugRenderTiles();
 }
 
 void Layer::EndFrame() {
-    if(m_meshDirty) {
-        m_meshNeedsRebuild = true;
-        m_mesh_builder.Clear();
-    }
+    m_builder_pool.Clear(m_dynamic_mesh_builder);
 }
 
 AABB2 Layer::CalcOrthoBounds() const {
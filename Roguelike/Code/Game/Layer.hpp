@@ -8,13 +8,25 @@
 
 #include "Engine/Renderer/Mesh.hpp"
 
+#include "Game/AnimationScheduler.hpp"
+#include "Game/BitGrid.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/MeshBuilderPool.hpp"
+#include "Game/QuadBatcher.hpp"
+#include "Game/TileInstanceStream.hpp"
+#include "Game/TileVertexStream.hpp"
 #include "Game/Tile.hpp"
 
+#include <array>
+#include <span>
+#include <utility>
+
 class Image;
 class Renderer;
 class Vector3;
 class Map;
 class Cursor;
+class RenderRecorder;
 
 class Layer {
 public:
@@ -30,6 +42,12 @@ public:
         SouthEast,
     };
 
+    enum class VisibilityState : uint8_t {
+        Unseen,
+        Remembered,
+        Visible,
+    };
+
     Layer() = default;
     explicit Layer(Map* map, const IntVector2& dimensions);
     explicit Layer(Map* map, const XMLElement& elem);
@@ -43,6 +61,7 @@ public:
     void BeginFrame();
     void Update(TimeUtils::FPSeconds deltaSeconds);
     void Render() const;
+    void Record(RenderRecorder& recorder) const noexcept;
     void DebugRender() const;
     void EndFrame();
 
@@ -59,10 +78,32 @@ public:
     Tile* GetTile(std::size_t index) noexcept;
     std::size_t GetTileIndex(std::size_t x, std::size_t y) const noexcept;
 
-    const Tile* GetNeighbor(const NeighborDirection& direction);
-    const Tile* GetNeighbor(const IntVector2& direction);
-
     void DirtyMesh() noexcept;
+    void DirtyMeshAt(const IntVector2& tile_coords) noexcept;
+    IntVector2 GetChunkDimensions() const noexcept;
+    IntVector2 GetChunkCount() const noexcept;
+    std::size_t GetChunkIndex(const IntVector2& tile_coords) const noexcept;
+
+    void DirtyStaticLight() noexcept;
+    bool IsStaticLightDirty() const noexcept;
+    uint32_t GetStaticLightValue(std::size_t index) const noexcept;
+    void SetStaticLightPlane(std::vector<uint8_t>&& plane) noexcept;
+
+    bool IsTileVisible(std::size_t index) const noexcept;
+    void SetTileVisible(std::size_t index) noexcept;
+    void ClearTileVisible(std::size_t index) noexcept;
+    bool IsTileExplored(std::size_t index) const noexcept;
+    void SetTileExplored(std::size_t index) noexcept;
+    void ClearTileExplored(std::size_t index) noexcept;
+    void ClearVisibility() noexcept;
+    std::span<const BitGrid::word_type> GetVisibilityBits() const noexcept;
+    std::span<const BitGrid::word_type> GetExploredBits() const noexcept;
+    VisibilityState GetVisibilityState(std::size_t index) const noexcept;
+    std::span<const VisibilityState> GetVisibilityStates() const noexcept;
+
+    bool IsTileOpaque(const IntVector2& tile_coords) const noexcept;
+    const BitGrid& GetOpacity() const noexcept;
+    void UpdateOpacityAt(const IntVector2& tile_coords) noexcept;
 
     int z_index{0};
     IntVector2 tileDimensions{1, 1};
@@ -70,6 +111,20 @@ public:
     Rgba debug_grid_color{Rgba::Red};
     std::size_t debug_tiles_in_view_count{};
     std::size_t debug_visible_tiles_in_view_count{};
+    std::size_t debug_chunks_rebuilt_count{};
+    TimeUtils::FPMilliseconds debug_chunk_build_time{};
+    QuadBatcher::Stats debug_terrain_batch_stats{};
+    QuadBatcher::Stats debug_dynamic_batch_stats{};
+    MeshBuilderPool::Stats debug_builder_pool_stats{};
+    std::size_t debug_tile_instance_count{};
+    std::size_t debug_tile_instance_bytes{};
+    TimeUtils::FPMilliseconds debug_tile_instance_build_time{};
+    std::size_t debug_tile_vertex_quad_count{};
+    std::size_t debug_tile_vertex_bytes{};
+    TimeUtils::FPMilliseconds debug_tile_vertex_build_time{};
+    bool parallel_chunk_builds{true};
+    bool build_tile_instances{false};
+    bool build_tile_vertices{false};
 
     std::vector<Tile>::const_iterator cbegin() const noexcept;
     std::vector<Tile>::const_iterator cend() const noexcept;
@@ -85,15 +140,26 @@ public:
 
     void DebugShowInvisibleTiles(bool show) noexcept;
 
-    void AppendToMesh(const Tile* const tile) noexcept;
-    void AppendToMesh(const Entity* const entity) noexcept;
-    void AppendToMesh(const Item* const item, const IntVector2& tile_coords) noexcept;
-    void AppendToMesh(const Inventory* const inventory, const IntVector2& tile_coords) noexcept;
-    void AppendToMesh(const IntVector2& tile_coords, const AABB2& uv_coords, const uint32_t light_value, Material* material) noexcept;
+    void BuildTileInstances(TileInstanceStream& stream) const noexcept;
+    const TileInstanceStream& GetTileInstances() const noexcept;
+    void BuildTileVertices(TileVertexStream& stream) const noexcept;
+    const TileVertexStream& GetTileVertices() const noexcept;
+
+    void AppendToMesh(QuadBatcher& batcher, const Tile* const tile) noexcept;
+    void AppendToMesh(QuadBatcher& batcher, const Entity* const entity) noexcept;
+    void AppendToMesh(QuadBatcher& batcher, const Item* const item, const IntVector2& tile_coords) noexcept;
+    void AppendToMesh(QuadBatcher& batcher, const Inventory* const inventory, const IntVector2& tile_coords) noexcept;
+    void AppendToMesh(QuadBatcher& batcher, const IntVector2& tile_coords, const AABB2& uv_coords, const uint32_t light_value, Material* material) noexcept;
     void AppendToMesh(const Cursor* cursor) noexcept;
 
 protected:
 private:
+    struct RenderChunk {
+        MeshBuilderPool::Handle builder{MeshBuilderPool::invalid_handle};
+        QuadBatcher batcher{};
+        std::vector<std::size_t> animated_tiles{};
+        bool dirty = true;
+    };
 
     bool LoadFromXml(const XMLElement& elem);
     bool LoadFromImage(const Image& img);
@@ -104,11 +170,58 @@ private:
     void DebugRenderTiles() const;
 
     void UpdateTiles(TimeUtils::FPSeconds deltaSeconds);
+    void UpdateViewableTiles(const IntVector2& view_mins, const IntVector2& view_maxs) noexcept;
+    void AppendViewableSpan(int y, int x_first, int x_last) noexcept;
+    void UpdateVisibility() noexcept;
+    void UpdateFogOfWar() noexcept;
+    void BuildRememberedMesh() noexcept;
+    void AppendRememberedToMesh(QuadBatcher& batcher, const Tile* const tile) noexcept;
+    void InitializeBitGrids() noexcept;
+    void CalculateCornerLight(const IntVector2& mins, const IntVector2& maxs) noexcept;
+    void CalculateLightColorTable() noexcept;
+    uint32_t GetCornerLightValue(int x, int y) const noexcept;
+    void AppendToMesh(QuadBatcher& batcher, const IntVector2& tile_coords, const AABB2& uv_coords, const std::array<Rgba, 4>& corner_colors, Material* material) noexcept;
+    void InitializeRenderChunks() noexcept;
+    void UpdateViewChunkBounds() noexcept;
+    void UpdateChunkBuilders() noexcept;
+    void UpdateRenderChunks() noexcept;
+    void BuildRenderChunk(const IntVector2& chunk_coords) noexcept;
+    void BuildDynamicMesh() noexcept;
+    void DirtyAnimatedChunks() noexcept;
+    void UpdateTileInstances() noexcept;
+    void UpdateTileVertices() noexcept;
+    template<typename Callback>
+    void ForEachVisibleTerrainTile(Callback&& callback) const noexcept;
+    void AppendEntitiesToMesh(QuadBatcher& batcher, const Tile* const tile) noexcept;
+    bool IsTileAnimated(const Tile* const tile) const noexcept;
+    const AnimationScheduler::SpriteFrame* GetTileFrame(const Tile* const tile) const noexcept;
+    std::pair<IntVector2, IntVector2> GetChunkTileBounds(const IntVector2& chunk_coords) const noexcept;
+    bool IsViewChunkBoundsEmpty() const noexcept;
 
     std::vector<Tile> m_tiles{};
     Map* m_map = nullptr;
-    Mesh::Builder m_mesh_builder{};
-    bool m_meshDirty = true;
-    bool m_meshNeedsRebuild = true;
+    MeshBuilderPool m_builder_pool{};
+    MeshBuilderPool::Handle m_dynamic_mesh_builder{m_builder_pool.Acquire()};
+    MeshBuilderPool::Handle m_remembered_mesh_builder{m_builder_pool.Acquire()};
+    QuadBatcher m_remembered_batcher{};
+    QuadBatcher m_dynamic_batcher{};
+    TileInstanceStream m_tile_instances{};
+    TileVertexStream m_tile_vertices{};
+    std::vector<RenderChunk> m_render_chunks{};
+    std::vector<IntVector2> m_chunks_to_build{};
+    std::vector<uint8_t> m_static_light{};
+    std::vector<uint8_t> m_corner_light{};
+    BitGrid m_visible_tiles{};
+    BitGrid m_explored_tiles{};
+    BitGrid m_opaque_tiles{};
+    std::vector<VisibilityState> m_visibility_states{};
+    std::vector<std::size_t> m_viewable_tiles{};
+    std::array<Rgba, max_light_value + 1> m_light_colors{};
+    IntVector2 m_mesh_bounds_mins{};
+    IntVector2 m_mesh_bounds_maxs{-1, -1};
+    IntVector2 m_view_chunk_mins{};
+    IntVector2 m_view_chunk_maxs{-1, -1};
+    bool m_staticLightDirty = true;
+    bool m_rememberedMeshDirty = true;
     bool m_showInvisibleTiles = false;
 };
@@ -0,0 +1,280 @@
+#include "Game/LightingHarness.hpp"
+
+#include "Engine/Core/DataUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include "Engine/Services/ServiceLocator.hpp"
+#include "Engine/Services/IFileLoggerService.hpp"
+
+#include "Game/Actor.hpp"
+#include "Game/Feature.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Layer.hpp"
+#include "Game/Map.hpp"
+#include "Game/Tile.hpp"
+#include "Game/TileDefinition.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <format>
+#include <random>
+#include <utility>
+
+void LightingHarness::RunAll(const std::filesystem::path& mapsFolder) noexcept {
+    _results.clear();
+    namespace FS = std::filesystem;
+    if(FS::exists(mapsFolder)) {
+        for(const auto& entry : FS::directory_iterator{mapsFolder}) {
+            if(!entry.is_regular_file() || entry.path().extension() != ".xml") {
+                continue;
+            }
+            //Adventure files list maps, they are not maps themselves.
+            tinyxml2::XMLDocument doc;
+            if(doc.LoadFile(entry.path().string().c_str()) != tinyxml2::XML_SUCCESS || !doc.RootElement() || std::string{doc.RootElement()->Name()} != "map") {
+                continue;
+            }
+            auto map = std::make_unique<Map>(entry.path());
+            RunMap(*map, entry.path().filename().string());
+        }
+    }
+    static constexpr std::array<int, 4> generated_sizes{32, 64, 128, Map::max_dimension};
+    for(const auto size : generated_sizes) {
+        auto map = CreateGeneratedMap(IntVector2{size, size}, static_cast<unsigned int>(size));
+        RunMap(*map, std::format("Generated {0}x{0}", size));
+    }
+}
+
+void LightingHarness::RunMap(Map& map, const std::string& name) noexcept {
+    RunFullRelight(map, name);
+    RunDayNightToggle(map, name);
+    RunLightSourceMoves(map, name);
+    RunFeatureToggles(map, name);
+}
+
+const std::vector<LightingHarness::Result>& LightingHarness::GetResults() const noexcept {
+    return _results;
+}
+
+bool LightingHarness::Passed() const noexcept {
+    return std::all_of(std::cbegin(_results), std::cend(_results), [](const Result& r) { return r.mismatches == 0u; });
+}
+
+void LightingHarness::LogResults() const noexcept {
+    auto* logger = ServiceLocator::get<IFileLoggerService>();
+    for(const auto& r : _results) {
+        const auto line = std::format("Lighting {0} [{1}]: {2} tiles, {3} processed, {4} baked, queue peak {5}, {6:.3f} ms, {7} mismatches", r.map_name, r.scenario, r.tile_count, r.tiles_processed, r.tiles_baked, r.queue_peak, r.time.count(), r.mismatches);
+        if(r.mismatches) {
+            logger->LogWarnLine(line);
+        } else {
+            logger->LogLine(line);
+        }
+        DebuggerPrintf(line + '\n');
+    }
+    logger->LogLineAndFlush(Passed() ? std::string{"Lighting harness: PASSED"} : std::string{"Lighting harness: FAILED"});
+}
+
+//Seeds straight from the tile and feature definitions and the layers above, without the sky flags
+//or Map::CalculateStaticLightSourceValue, so a seeding bug in Map shows up as mismatches.
+uint32_t LightingHarness::CalculateReferenceSourceValue(const Map& map, Layer& layer, std::size_t index, std::size_t voidDefinitionId) noexcept {
+    const auto* tile = layer.GetTile(index);
+    uint32_t value{0u};
+    if(const auto* def = TileDefinition::GetTileDefinitionByName(tile->GetType()); def != nullptr) {
+        value = def->light;
+    }
+    bool open_to_sky = true;
+    for(const auto* up = tile->GetUpNeighbor(); up != nullptr; up = up->GetUpNeighbor()) {
+        if(up->GetDefinitionId() != voidDefinitionId) {
+            open_to_sky = false;
+            break;
+        }
+    }
+    const auto coords = tile->GetCoords();
+    const bool at_edge = coords.x == 0 || coords.y == 0 || coords.x == layer.tileDimensions.x - 1 || coords.y == layer.tileDimensions.y - 1;
+    if(open_to_sky || (at_edge && tile->IsOpaque())) {
+        value = (std::max)(value, static_cast<uint32_t>(map.GetCurrentGlobalLightValue()));
+    }
+    if(const auto* feature = tile->feature; feature != nullptr) {
+        if(const auto* def = TileDefinition::GetTileDefinitionByName(feature->GetFullyQualifiedNameFromCurrentState()); def != nullptr) {
+            value = (std::max)(value, def->light);
+        }
+    }
+    if(const auto* actor = tile->actor; actor != nullptr) {
+        value = (std::max)(value, actor->GetLightValue());
+    }
+    return (std::min)(value, static_cast<uint32_t>(max_light_value));
+}
+
+//Brute force: start every tile at its own source value and relax every tile
+//against its neighbors until nothing changes. Shares no code with the lighting queue.
+std::vector<uint32_t> LightingHarness::CalculateReferenceLighting(const Map& map, Layer& layer) noexcept {
+    const auto tileCount = static_cast<std::size_t>(layer.tileDimensions.x) * static_cast<std::size_t>(layer.tileDimensions.y);
+    std::vector<uint32_t> reference(tileCount, uint32_t{0u});
+    const auto void_id = TileDefinition::GetTileDefinitionIdByName("void");
+    for(auto i = std::size_t{0u}; i != tileCount; ++i) {
+        reference[i] = CalculateReferenceSourceValue(map, layer, i, void_id);
+    }
+    for(bool changed = true; changed;) {
+        changed = false;
+        for(auto i = std::size_t{0u}; i != tileCount; ++i) {
+            const auto ti = TileInfo{&layer, i};
+            if(ti.IsOpaque()) {
+                continue;
+            }
+            for(const auto& neighbor : ti.GetCardinalNeighbors()) {
+                if(neighbor.index != i && reference[neighbor.index] > reference[i] + 1u) {
+                    reference[i] = reference[neighbor.index] - 1u;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return reference;
+}
+
+std::size_t LightingHarness::CountMismatches(const Map& map) noexcept {
+    std::size_t mismatches{0u};
+    for(auto i = std::size_t{0u}; i != map.GetLayerCount(); ++i) {
+        auto* layer = map.GetLayer(i);
+        const auto reference = CalculateReferenceLighting(map, *layer);
+        for(auto index = std::size_t{0u}; index != reference.size(); ++index) {
+            if(layer->GetTile(index)->GetLightValue() != reference[index]) {
+                ++mismatches;
+            }
+        }
+    }
+    return mismatches;
+}
+
+std::unique_ptr<Map> LightingHarness::CreateGeneratedMap(const IntVector2& dimensions, unsigned int seed) const noexcept {
+    auto map = std::make_unique<Map>(dimensions);
+    std::mt19937 rng{seed};
+    std::bernoulli_distribution is_wall{0.3};
+    auto* layer = map->GetLayer(0);
+    for(auto& tile : *layer) {
+        const auto coords = tile.GetCoords();
+        //Leave a border of sky so the global light has somewhere to enter.
+        const bool is_border = coords.x == 0 || coords.y == 0 || coords.x == layer->tileDimensions.x - 1 || coords.y == layer->tileDimensions.y - 1;
+        tile.ChangeTypeFromName(is_border ? "void" : (is_wall(rng) ? "wall" : "grass"));
+    }
+    map->SetDebugGlobalLight(night_light_value);
+    for(auto i = std::size_t{0u}; i != map->GetLayerCount(); ++i) {
+        map->InitializeLighting(map->GetLayer(i));
+    }
+    map->UpdateLighting(TimeUtils::FPSeconds{0.0f});
+    return map;
+}
+
+LightingHarness::Result LightingHarness::Measure(Map& map, const std::string& name, const std::string& scenario, const std::function<void()>& work) noexcept {
+    map.ResetLightingStats();
+    const auto start = std::chrono::steady_clock::now();
+    work();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    Result result{};
+    result.map_name = name;
+    result.scenario = scenario;
+    for(auto i = std::size_t{0u}; i != map.GetLayerCount(); ++i) {
+        const auto* layer = map.GetLayer(i);
+        result.tile_count += static_cast<std::size_t>(layer->tileDimensions.x) * static_cast<std::size_t>(layer->tileDimensions.y);
+    }
+    const auto& stats = map.GetLightingStats();
+    result.tiles_processed = stats.tiles_processed;
+    result.tiles_baked = stats.tiles_baked;
+    result.queue_peak = stats.queue_peak;
+    result.time = elapsed;
+    result.mismatches = CountMismatches(map);
+    _results.push_back(result);
+    return result;
+}
+
+void LightingHarness::RunFullRelight(Map& map, const std::string& name) noexcept {
+    Measure(map, name, "full relight", [&map]() {
+        for(auto i = std::size_t{0u}; i != map.GetLayerCount(); ++i) {
+            map.InitializeLighting(map.GetLayer(i));
+        }
+        map.UpdateLighting(TimeUtils::FPSeconds{0.0f});
+    });
+}
+
+void LightingHarness::RunDayNightToggle(Map& map, const std::string& name) noexcept {
+    const auto original_light = static_cast<uint32_t>(map.GetCurrentGlobalLightValue());
+    const auto relight_at = [&map](uint32_t global_light) {
+        map.SetDebugGlobalLight(global_light);
+        map.CalculateLightingForLayers(TimeUtils::FPSeconds{0.0f});
+        map.UpdateLighting(TimeUtils::FPSeconds{0.0f});
+    };
+    Measure(map, name, "to day", [&]() { relight_at(day_light_value); });
+    Measure(map, name, "to night", [&]() { relight_at(night_light_value); });
+    relight_at(original_light);
+}
+
+void LightingHarness::RunLightSourceMoves(Map& map, const std::string& name) noexcept {
+    Actor* actor = map.player ? map.player : (map._actors.empty() ? nullptr : map._actors.front());
+    if(actor == nullptr || actor->tile == nullptr) {
+        return;
+    }
+    const auto original_position = actor->GetPosition();
+    const auto original_light = actor->GetLightValue();
+    const auto move_to = [&map, actor](const IntVector2& position) {
+        auto from = TileInfo{actor->layer, actor->tile->GetIndexFromCoords()};
+        actor->SetPosition(position);
+        auto to = TileInfo{actor->layer, actor->tile->GetIndexFromCoords()};
+        map.DirtyTileLight(from);
+        map.DirtyCardinalNeighbors(from);
+        map.DirtyTileLight(to);
+        map.UpdateLighting(TimeUtils::FPSeconds{0.0f});
+    };
+    //Walk a carrying torch around a ring centered on the actor's start.
+    static constexpr std::array<IntVector2, 8> ring{IntVector2{-3, -3}, IntVector2{0, -3}, IntVector2{3, -3}, IntVector2{3, 0}, IntVector2{3, 3}, IntVector2{0, 3}, IntVector2{-3, 3}, IntVector2{-3, 0}};
+    Measure(map, name, "moving light", [&]() {
+        actor->SetLightValue(max_light_value - 4);
+        for(const auto& offset : ring) {
+            const auto target = original_position + offset;
+            if(target.x < 0 || target.y < 0 || target.x >= actor->layer->tileDimensions.x || target.y >= actor->layer->tileDimensions.y) {
+                continue;
+            }
+            if(map.IsTilePassable(target)) {
+                move_to(target);
+            }
+        }
+    });
+    actor->SetLightValue(original_light);
+    move_to(original_position);
+}
+
+void LightingHarness::RunFeatureToggles(Map& map, const std::string& name) noexcept {
+    std::vector<std::pair<Feature*, std::string>> toggles{};
+    for(auto* feature : map._features) {
+        if(feature->layer == nullptr || feature->tile == nullptr) {
+            continue;
+        }
+        const auto info = FeatureInfo{feature->layer, feature->tile->GetIndexFromCoords()};
+        if(info.GetStates().size() > std::size_t{1u}) {
+            toggles.emplace_back(feature, info.GetCurrentState());
+        }
+    }
+    if(toggles.empty()) {
+        return;
+    }
+    const auto set_state = [&map](Feature* feature, const std::string& state) {
+        feature->SetState(state);
+        map.CalculateLightingForLayers(TimeUtils::FPSeconds{0.0f});
+        map.UpdateLighting(TimeUtils::FPSeconds{0.0f});
+    };
+    //Light torches and open doors one at a time, relighting after each as a turn would, then put them back.
+    Measure(map, name, "feature toggle", [&]() {
+        for(const auto& [feature, original_state] : toggles) {
+            const auto states = FeatureInfo{feature->layer, feature->tile->GetIndexFromCoords()}.GetStates();
+            auto next = std::find(std::cbegin(states), std::cend(states), original_state);
+            if(next == std::cend(states) || ++next == std::cend(states)) {
+                next = std::cbegin(states);
+            }
+            set_state(feature, *next);
+        }
+    });
+    Measure(map, name, "feature restore", [&]() {
+        for(const auto& [feature, original_state] : toggles) {
+            set_state(feature, original_state);
+        }
+    });
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include "Engine/Math/IntVector2.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Layer;
+class Map;
+
+//Runs full relights, day/night toggles, scripted light-source moves, and torch and
+//door state changes against every map in a folder plus generated maps, and checks
+//each result against a brute-force reference solver.
+class LightingHarness {
+public:
+    struct Result {
+        std::string map_name{};
+        std::string scenario{};
+        std::size_t tile_count{};
+        std::size_t tiles_processed{};
+        std::size_t tiles_baked{};
+        std::size_t queue_peak{};
+        TimeUtils::FPMilliseconds time{};
+        std::size_t mismatches{};
+    };
+
+    LightingHarness() = default;
+    LightingHarness(const LightingHarness& other) = default;
+    LightingHarness(LightingHarness&& other) = default;
+    LightingHarness& operator=(const LightingHarness& other) = default;
+    LightingHarness& operator=(LightingHarness&& other) = default;
+    ~LightingHarness() = default;
+
+    void RunAll(const std::filesystem::path& mapsFolder) noexcept;
+    void RunMap(Map& map, const std::string& name) noexcept;
+
+    const std::vector<Result>& GetResults() const noexcept;
+    bool Passed() const noexcept;
+    void LogResults() const noexcept;
+
+    static std::vector<uint32_t> CalculateReferenceLighting(const Map& map, Layer& layer) noexcept;
+    static uint32_t CalculateReferenceSourceValue(const Map& map, Layer& layer, std::size_t index, std::size_t voidDefinitionId) noexcept;
+    static std::size_t CountMismatches(const Map& map) noexcept;
+
+protected:
+private:
+    std::unique_ptr<Map> CreateGeneratedMap(const IntVector2& dimensions, unsigned int seed) const noexcept;
+    Result Measure(Map& map, const std::string& name, const std::string& scenario, const std::function<void()>& work) noexcept;
+
+    void RunFullRelight(Map& map, const std::string& name) noexcept;
+    void RunDayNightToggle(Map& map, const std::string& name) noexcept;
+    void RunLightSourceMoves(Map& map, const std::string& name) noexcept;
+    void RunFeatureToggles(Map& map, const std::string& name) noexcept;
+
+    std::vector<Result> _results{};
+};
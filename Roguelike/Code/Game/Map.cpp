@@ -36,10 +36,12 @@
 #include "Game/Layer.hpp"
 #include "Game/MapGenerator.hpp"
 #include "Game/Pathfinder.hpp"
+#include "Game/RaycastBatch.hpp"
 #include "Game/TileDefinition.hpp"
 #include "Game/Tile.hpp"
 
 #include <algorithm>
+#include <array>
 #include <sstream>
 
 const Rgba& Map::GetSkyColorForDay() noexcept {
@@ -132,6 +134,7 @@ void Map::ShakeCamera(const IntVector2& from, const IntVector2& to) noexcept {
 }
 
 void Map::SetGlobalLightFromSkyColor() noexcept {
+    const auto previous_global_light = _current_global_light;
     if(_current_sky_color == GetSkyColorForDay()) {
         _current_global_light = day_light_value;
     } else if(_current_sky_color == GetSkyColorForNight()) {
@@ -139,6 +142,9 @@ void Map::SetGlobalLightFromSkyColor() noexcept {
     } else if(_current_sky_color == GetSkyColorForCave()) {
         _current_global_light = min_light_value;
     }
+    if(previous_global_light != _current_global_light) {
+        DirtyStaticLightForLayers();
+    }
 }
 
 void Map::SetSkyColorFromGlobalLight() noexcept {
@@ -223,6 +229,122 @@ std::size_t Map::DebugVisibleTilesInViewCount() const {
     return _debug_visible_tiles_in_view_count;
 }
 
+std::size_t Map::DebugChunksRebuiltCount() const {
+    std::size_t count{0u};
+    for(const auto& layer : _layers) {
+        count += layer->debug_chunks_rebuilt_count;
+    }
+    return count;
+}
+
+TimeUtils::FPMilliseconds Map::DebugChunkBuildTime() const {
+    TimeUtils::FPMilliseconds time{0.0f};
+    for(const auto& layer : _layers) {
+        time += layer->debug_chunk_build_time;
+    }
+    return time;
+}
+
+QuadBatcher::Stats Map::DebugTerrainBatchStats() const {
+    QuadBatcher::Stats stats{};
+    for(const auto& layer : _layers) {
+        stats += layer->debug_terrain_batch_stats;
+    }
+    return stats;
+}
+
+QuadBatcher::Stats Map::DebugDynamicBatchStats() const {
+    QuadBatcher::Stats stats{};
+    for(const auto& layer : _layers) {
+        stats += layer->debug_dynamic_batch_stats;
+    }
+    return stats;
+}
+
+MeshBuilderPool::Stats Map::DebugBuilderPoolStats() const {
+    MeshBuilderPool::Stats stats{};
+    for(const auto& layer : _layers) {
+        stats.builders += layer->debug_builder_pool_stats.builders;
+        stats.in_use += layer->debug_builder_pool_stats.in_use;
+        stats.reallocations += layer->debug_builder_pool_stats.reallocations;
+    }
+    return stats;
+}
+
+void Map::SetParallelChunkBuilds(bool parallel) noexcept {
+    for(auto& layer : _layers) {
+        layer->parallel_chunk_builds = parallel;
+    }
+}
+
+std::size_t Map::DebugTileInstanceCount() const {
+    std::size_t count{0u};
+    for(const auto& layer : _layers) {
+        count += layer->debug_tile_instance_count;
+    }
+    return count;
+}
+
+std::size_t Map::DebugTileInstanceBytes() const {
+    std::size_t bytes{0u};
+    for(const auto& layer : _layers) {
+        bytes += layer->debug_tile_instance_bytes;
+    }
+    return bytes;
+}
+
+TimeUtils::FPMilliseconds Map::DebugTileInstanceBuildTime() const {
+    TimeUtils::FPMilliseconds time{0.0f};
+    for(const auto& layer : _layers) {
+        time += layer->debug_tile_instance_build_time;
+    }
+    return time;
+}
+
+void Map::SetBuildTileInstances(bool build) noexcept {
+    for(auto& layer : _layers) {
+        layer->build_tile_instances = build;
+    }
+}
+
+std::size_t Map::DebugTileVertexQuadCount() const {
+    std::size_t count{0u};
+    for(const auto& layer : _layers) {
+        count += layer->debug_tile_vertex_quad_count;
+    }
+    return count;
+}
+
+std::size_t Map::DebugTileVertexBytes() const {
+    std::size_t bytes{0u};
+    for(const auto& layer : _layers) {
+        bytes += layer->debug_tile_vertex_bytes;
+    }
+    return bytes;
+}
+
+TimeUtils::FPMilliseconds Map::DebugTileVertexBuildTime() const {
+    TimeUtils::FPMilliseconds time{0.0f};
+    for(const auto& layer : _layers) {
+        time += layer->debug_tile_vertex_build_time;
+    }
+    return time;
+}
+
+void Map::SetBuildTileVertices(bool build) noexcept {
+    for(auto& layer : _layers) {
+        layer->build_tile_vertices = build;
+    }
+}
+
+void Map::SetCursorUpdatesEnabled(bool enabled) noexcept {
+    _cursor_updates_enabled = enabled;
+}
+
+const std::filesystem::path& Map::GetFilepath() const noexcept {
+    return m_filepath;
+}
+
 void Map::RegenerateMap() noexcept {
     _map_generator.Generate();
 }
@@ -237,16 +359,10 @@ Pathfinder* Map::GetPathfinder() noexcept {
 
 void Map::ZoomOut() noexcept {
     cameraController.ZoomOut();
-    for(auto& layer : _layers) {
-        layer->DirtyMesh();
-    }
 }
 
 void Map::ZoomIn() noexcept {
     cameraController.ZoomIn();
-    for(auto& layer : _layers) {
-        layer->DirtyMesh();
-    }
 }
 
 void Map::SetDebugGridColor(const Rgba& gridColor) {
@@ -255,6 +371,9 @@ void Map::SetDebugGridColor(const Rgba& gridColor) {
 }
 
 void Map::SetDebugGlobalLight(uint32_t lightValue) {
+    if(_current_global_light != lightValue) {
+        DirtyStaticLightForLayers();
+    }
     _current_global_light = lightValue;
 }
 
@@ -276,6 +395,15 @@ void Map::KillActor(Actor& a) {
 
 void Map::KillFeature(Feature& f) {
     f.tile->feature = nullptr;
+    f.layer->UpdateOpacityAt(f.tile->GetCoords());
+}
+
+void Map::OnOpacityChanged(const Layer& layer, const IntVector2& tile_coords) noexcept {
+    for(auto* actor : _actors) {
+        if(actor && actor->layer == &layer) {
+            actor->OnOpacityChanged(tile_coords);
+        }
+    }
 }
 
 const std::vector<Entity*>& Map::GetEntities() const noexcept {
@@ -436,22 +564,40 @@ void Map::BeginFrame() {
 
 void Map::Update(TimeUtils::FPSeconds deltaSeconds) {
     cameraController.Update(deltaSeconds);
+    UpdateAnimations(deltaSeconds);
     UpdateLayers(deltaSeconds);
     UpdateTextEntities(deltaSeconds);
     UpdateEntities(deltaSeconds);
     CalculateLightingForLayers(deltaSeconds);
     UpdateLighting(deltaSeconds);
     FocusCameraOnPlayer(deltaSeconds);
-    ShouldRenderStatWindow();
-    SetCursorForTile();
+    if(_cursor_updates_enabled) {
+        ShouldRenderStatWindow();
+        SetCursorForTile();
+    }
+}
+
+//Sprites are gathered on the first frame and again only after a definition reload.
+void Map::UpdateAnimations(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    if(_animation_scheduler.IsTrackingStale()) {
+        _animation_scheduler.Clear();
+        _animation_scheduler.TrackDefinitionSprites();
+    }
+    _animation_scheduler.Update(deltaSeconds);
+}
+
+const AnimationScheduler& Map::GetAnimationScheduler() const noexcept {
+    return _animation_scheduler;
 }
 
 void Map::UpdateLayers(TimeUtils::FPSeconds deltaSeconds) {
     for(auto& layer : _layers) {
         layer->Update(deltaSeconds);
     }
-    UpdateCursor(deltaSeconds);
-    AddCursorToTopLayer();
+    if(_cursor_updates_enabled) {
+        UpdateCursor(deltaSeconds);
+        AddCursorToTopLayer();
+    }
 }
 
 void Map::FocusCameraOnPlayer(TimeUtils::FPSeconds deltaSeconds) noexcept {
@@ -497,8 +643,9 @@ void Map::UpdateTextEntities(TimeUtils::FPSeconds deltaSeconds) {
 
 void Map::UpdateLighting(TimeUtils::FPSeconds /*deltaSeconds*/) noexcept {
     while(!_lightingQueue.empty()) {
-        TileInfo& ti = _lightingQueue.front();
+        TileInfo ti = _lightingQueue.front();
         _lightingQueue.pop_front();
+        ++_lighting_stats.tiles_processed;
         ti.ClearLightDirty();
         UpdateTileLighting(ti);
     }
@@ -508,43 +655,143 @@ void Map::InitializeLighting(Layer* layer) noexcept {
     if (layer == nullptr) {
         return;
     }
-    layer->DirtyMesh();
-    const auto tileCount = layer->tileDimensions.x * layer->tileDimensions.y;
-    for (int i = 0; i < tileCount; ++i) {
-        auto* currentTile = layer->GetTile(i);
-        currentTile->SetLightValue(0);
-        currentTile->SetLightDirty();
-        //if (const auto* def = TileDefinition::GetTileDefinitionByName(currentTile->GetType()); def && def->self_illumination > 0) {
-            TileInfo ti{};
-            ti.index = i;
-            ti.layer = layer;
-            _lightingQueue.push_back(ti);
-        //}
-    }
-    CalculateLighting(layer);
+    CalculateSkyLight(layer);
+    BakeStaticLighting(layer);
+    DirtyDynamicLightSources(layer);
 }
 
 void Map::CalculateLighting(Layer* layer) noexcept {
+    if(layer == nullptr || !layer->IsStaticLightDirty()) {
+        return;
+    }
+    BakeStaticLighting(layer);
+    DirtyDynamicLightSources(layer);
+}
+
+void Map::CalculateSkyLight(Layer* layer) noexcept {
     if(layer == nullptr) {
         return;
     }
-    const auto width = static_cast<std::size_t>(layer->tileDimensions.x);
-    const auto height = static_cast<std::size_t>(layer->tileDimensions.y);
-    const auto tileCount = width * height;
-    for (auto i = std::size_t{}; i != tileCount; ++i) {
-        if (auto* tile = layer->GetTile(i); tile && tile->IsOpaque()) {
-            break;
+    const auto void_id = TileDefinition::GetTileDefinitionIdByName("void");
+    for(auto& tile : *layer) {
+        if(IsTileOpenToSky(tile, void_id)) {
+            tile.SetSky();
         } else {
-            tile->SetSky();
-            tile->SetLightValue(_current_global_light);
+            tile.ClearSky();
         }
     }
-    for (auto i = std::size_t{}; i != tileCount; ++i) {
-        TileInfo ti{ layer, i };
-        if (ti.IsOpaque()) {
+}
+
+//A tile is open when every tile stacked above it is empty void, which includes having no layer above it at all.
+//The tile's own type does not matter: grass or floor under open sky is lit by it.
+bool Map::IsTileOpenToSky(const Tile& tile, std::size_t voidDefinitionId) const noexcept {
+    for(const auto* up = tile.GetUpNeighbor(); up != nullptr; up = up->GetUpNeighbor()) {
+        if(up->GetDefinitionId() != voidDefinitionId) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Map::UpdateSkyLightColumn(const Tile& changedTile) noexcept {
+    const auto* changed_layer = changedTile.layer;
+    if(changed_layer == nullptr || GetLayer(changed_layer->z_index) != changed_layer) {
+        //Layer is still being built; InitializeLighting computes the whole layer.
+        return;
+    }
+    const auto coords = changedTile.GetCoords();
+    const auto void_id = TileDefinition::GetTileDefinitionIdByName("void");
+    //A tile's exposure only depends on the tiles above it, so start below the changed tile and stop at the first tile that does not change.
+    for(auto z = changed_layer->z_index - 1; z >= 0; --z) {
+        auto* tile = GetTile(coords.x, coords.y, z);
+        if(tile == nullptr) {
+            break;
+        }
+        const auto is_open = IsTileOpenToSky(*tile, void_id);
+        if(is_open == tile->IsSky()) {
             break;
         }
-        DirtyValidNeighbors(ti);
+        if(is_open) {
+            tile->SetSky();
+        } else {
+            tile->ClearSky();
+        }
+        tile->layer->DirtyStaticLight();
+    }
+}
+
+//Static light only changes when tiles, doors, or the global light change,
+//so it is flooded once into a per-layer plane instead of every turn.
+//Flooding in descending light order visits each tile at most once per level.
+void Map::BakeStaticLighting(Layer* layer) noexcept {
+    if(layer == nullptr) {
+        return;
+    }
+    const auto tileCount = static_cast<std::size_t>(layer->tileDimensions.x) * static_cast<std::size_t>(layer->tileDimensions.y);
+    std::vector<uint8_t> baked(tileCount, uint8_t{0u});
+    std::array<std::vector<std::size_t>, max_light_value + 1> frontiers{};
+    for(auto i = std::size_t{0u}; i != tileCount; ++i) {
+        const auto value = CalculateStaticLightSourceValue(TileInfo{layer, i});
+        baked[i] = static_cast<uint8_t>(value);
+        if(value > 1u) {
+            frontiers[value].push_back(i);
+        }
+    }
+    for(auto level = max_light_value; level > 1; --level) {
+        const auto next_level = static_cast<uint8_t>(level - 1);
+        for(const auto i : frontiers[level]) {
+            if(baked[i] != level) {
+                continue;
+            }
+            for(const auto& neighbor : TileInfo{layer, i}.GetCardinalNeighbors()) {
+                if(neighbor.index == i || neighbor.IsOpaque()) {
+                    continue;
+                }
+                if(baked[neighbor.index] < next_level) {
+                    baked[neighbor.index] = next_level;
+                    frontiers[next_level].push_back(neighbor.index);
+                }
+            }
+        }
+    }
+    //Only chunks around tiles whose light actually changed are rebuilt.
+    for(auto i = std::size_t{0u}; i != tileCount; ++i) {
+        TileInfo{layer, i}.SetLightValue(baked[i]);
+    }
+    _lighting_stats.tiles_baked += tileCount;
+    layer->SetStaticLightPlane(std::move(baked));
+}
+
+uint32_t Map::CalculateStaticLightSourceValue(const TileInfo& ti) const noexcept {
+    uint32_t value = ti.GetSelfIlluminationValue();
+    if(ti.IsSky() || (ti.IsAtEdge() && ti.IsOpaque())) {
+        value = (std::max)(value, _current_global_light);
+    }
+    //Features that can change state (torches, doors) belong to the dynamic overlay.
+    if(ti.HasFeature() && !FeatureInfo{ti.layer, ti.index}.HasStates()) {
+        value = (std::max)(value, ti.GetFeatureLightValue());
+    }
+    return (std::min)(value, static_cast<uint32_t>(max_light_value));
+}
+
+void Map::DirtyDynamicLightSources(Layer* layer) noexcept {
+    for(auto* actor : _actors) {
+        if(actor->layer == layer && actor->tile) {
+            TileInfo ti{layer, actor->tile->GetIndexFromCoords()};
+            DirtyTileLight(ti);
+        }
+    }
+    for(auto* feature : _features) {
+        if(feature->layer == layer && feature->tile) {
+            TileInfo ti{layer, feature->tile->GetIndexFromCoords()};
+            DirtyTileLight(ti);
+        }
+    }
+}
+
+void Map::DirtyStaticLightForLayers() noexcept {
+    for(auto& layer : _layers) {
+        layer->DirtyStaticLight();
     }
 }
 
@@ -580,18 +827,25 @@ void Map::DirtyTileLight(TileInfo& ti) noexcept {
     }
     _lightingQueue.push_back(ti);
     ti.SetLightDirty();
+    _lighting_stats.queue_peak = (std::max)(_lighting_stats.queue_peak, _lightingQueue.size());
+}
+
+const Map::LightingStats& Map::GetLightingStats() const noexcept {
+    return _lighting_stats;
+}
+
+void Map::ResetLightingStats() noexcept {
+    _lighting_stats = LightingStats{};
 }
 
 void Map::UpdateTileLighting(TileInfo& ti) noexcept {
-    uint32_t idealLighting = ti.GetSelfIlluminationValue();
+    //Baked static light is the floor; only actors and stateful features are overlaid on top of it.
+    uint32_t idealLighting = ti.GetStaticLightValue();
     if (!ti.IsOpaque()) {
         if (const auto highestNeighborLightValue = ti.GetMaxLightValueFromNeighbors(); highestNeighborLightValue > 0) {
             idealLighting = (std::max)(idealLighting, highestNeighborLightValue - 1);
         }
     }
-    if (ti.IsSky() || (ti.IsAtEdge() && ti.IsOpaque())) {
-        idealLighting = (std::max)(idealLighting, _current_global_light);
-    }
     idealLighting = (std::max)(idealLighting, ti.GetActorLightValue());
     idealLighting = (std::max)(idealLighting, ti.GetFeatureLightValue());
     if (idealLighting != ti.GetLightValue()) {
@@ -683,6 +937,15 @@ void Map::Render() const {
 
 }
 
+void Map::Record(RenderRecorder& recorder) const noexcept {
+    for(const auto& layer : _layers) {
+        layer->Record(recorder);
+    }
+    for(auto* entity : _text_entities) {
+        entity->Record(recorder);
+    }
+}
+
 void Map::DebugRender() const {
 #ifdef UI_DEBUG
     for(const auto& layer : _layers) {
@@ -974,78 +1237,62 @@ void Map::FocusEntity(const Entity* entity) {
     }
 }
 
-Map::RaycastResult2D Map::HasLineOfSight(const Vector2& startPosition, const Vector2& endPosition) const {
+Map::RaycastHit2D Map::HasLineOfSight(const Vector2& startPosition, const Vector2& endPosition) const {
     const auto displacement = endPosition - startPosition;
     const auto direction = displacement.GetNormalize();
     float length = displacement.CalcLength();
     return HasLineOfSight(startPosition, direction, length);
 }
 
-Map::RaycastResult2D Map::HasLineOfSight(const Vector2& startPosition, const Vector2& direction, float maxDistance) const {
-    return Raycast(startPosition, direction, maxDistance, true, [this](const IntVector2& tileCoords)->bool { return this->IsTileOpaque(tileCoords); });
+Map::RaycastHit2D Map::HasLineOfSight(const Vector2& startPosition, const Vector2& direction, float maxDistance) const {
+    return RaycastHit(startPosition, direction, maxDistance, true, [this](const IntVector2& tileCoords)->bool { return this->IsTileOpaque(tileCoords); });
 }
 
-bool Map::IsTileWithinDistance(const Tile& startTile, unsigned int manhattanDist) const {
-    auto visibleTiles = GetTilesWithinDistance(startTile, manhattanDist);
-    bool isWithinDistance = false;
-    for(auto& t : visibleTiles) {
-        auto calculatedManhattanDist = MathUtils::CalculateManhattanDistance(startTile.GetCoords(), t->GetCoords());
-        if(calculatedManhattanDist < manhattanDist) {
-            isWithinDistance = true;
-            break;
-        }
+void Map::HasLineOfSight(const Vector2& startPosition, std::span<const Vector2> endPositions, std::span<RaycastHit2D> results, std::size_t layerIndex /*= 0u*/) const noexcept {
+    if(const auto* layer = GetLayer(layerIndex)) {
+        RaycastBatch::Cast(layer->GetOpacity(), startPosition, endPositions, results);
     }
-    return isWithinDistance;
+}
+
+bool Map::IsTileWithinDistance(const Tile& startTile, unsigned int manhattanDist) const {
+    return !GetTilesInRadius(startTile.GetCoords(), static_cast<float>(manhattanDist), TileDistanceMetric::Manhattan).empty();
 }
 
 bool Map::IsTileWithinDistance(const Tile& startTile, float dist) const {
-    auto visibleTiles = GetTilesWithinDistance(startTile, dist);
-    bool isWithinDistance = false;
-    for(auto& t : visibleTiles) {
-        auto calculatedDistSq = (Vector2(startTile.GetCoords()) - Vector2(t->GetCoords())).CalcLengthSquared();
-        if(calculatedDistSq < dist * dist) {
-            isWithinDistance = true;
-            break;
-        }
-    }
-    return isWithinDistance;
+    return !GetTilesInRadius(startTile.GetCoords(), dist, TileDistanceMetric::Euclidean).empty();
+}
+
+TileRange Map::GetTilesInRadius(const IntVector2& center, float radius, TileDistanceMetric metric, std::size_t layerIndex /*= 0u*/) const noexcept {
+    return TileRange{GetLayer(layerIndex), center, radius, metric};
 }
 
 std::vector<Tile*> Map::GetTilesWithinDistance(const Tile& startTile, unsigned int manhattanDist) const {
-    return this->GetTilesWithinDistance(startTile, static_cast<float>(manhattanDist), [&](const IntVector2& start, const IntVector2& end) { return MathUtils::CalculateManhattanDistance(start, end); });
-    //std::vector<Tile*> results{};
-    //const auto& layer0 = _layers[0];
-    //for(auto& tile : *layer0) {
-    //    auto calculatedManhattanDist = MathUtils::CalculateManhattanDistance(startTile.GetCoords(), tile.GetCoords());
-    //    if(calculatedManhattanDist < manhattanDist) {
-    //        results.push_back(&tile);
-    //    }
-    //}
-    //return results;
+    const auto range = GetTilesInRadius(startTile.GetCoords(), static_cast<float>(manhattanDist), TileDistanceMetric::Manhattan);
+    return std::vector<Tile*>(std::begin(range), std::end(range));
 }
 
 std::vector<Tile*> Map::GetTilesWithinDistance(const Tile& startTile, float dist) const {
-    return this->GetTilesWithinDistance(startTile, dist * dist, [&](const IntVector2& start, const IntVector2& end) { return (Vector2(end) - Vector2(start)).CalcLengthSquared(); });
-    //std::vector<Tile*> results;
-    //const auto& layer0 = _layers[0];
-    //for(auto& tile : *layer0) {
-    //    auto calculatedDistSq = (Vector2(startTile.GetCoords()) - Vector2(tile.GetCoords())).CalcLengthSquared();
-    //    if(calculatedDistSq < dist * dist) {
-    //        results.push_back(&tile);
-    //    }
-    //}
-    //return results;
+    const auto range = GetTilesInRadius(startTile.GetCoords(), dist, TileDistanceMetric::Euclidean);
+    return std::vector<Tile*>(std::begin(range), std::end(range));
 }
 
 std::vector<Tile*> Map::GetVisibleTilesWithinDistance(const Tile& startTile, unsigned int manhattanDist) const {
-    std::vector<Tile*> results = GetTilesWithinDistance(startTile, manhattanDist);
-    results.erase(std::remove_if(std::begin(results), std::end(results), [this, &startTile](Tile* tile) { return tile->IsInvisible(); }), std::end(results));
+    std::vector<Tile*> results{};
+    for(auto* tile : GetTilesInRadius(startTile.GetCoords(), static_cast<float>(manhattanDist), TileDistanceMetric::Manhattan)) {
+        if(!tile->IsInvisible()) {
+            results.push_back(tile);
+        }
+    }
     return results;
 }
 
 std::vector<Tile*> Map::GetVisibleTilesWithinDistance(const Tile& startTile, float dist) const {
-    std::vector<Tile*> results = GetTilesWithinDistance(startTile, dist);
-    results.erase(std::remove_if(std::begin(results), std::end(results), [this, &startTile](Tile* tile) { return tile->IsInvisible(); }), std::end(results));
+    std::vector<Tile*> results{};
+    for(auto* tile : GetTilesInRadius(startTile.GetCoords(), dist, TileDistanceMetric::Euclidean)) {
+        if(!tile->IsInvisible()) {
+            results.push_back(tile);
+        }
+    }
     return results;
 }
 
@@ -1133,6 +1380,10 @@ std::size_t Map::GetLayerCount() const {
     return _layers.size();
 }
 
+IntVector2 Map::GetChunkDimensions() const noexcept {
+    return IntVector2{static_cast<int>(m_chunkWidth), static_cast<int>(m_chunkHeight)};
+}
+
 Layer* Map::GetLayer(std::size_t index) const {
     if(index >= _layers.size()) {
         return nullptr;
@@ -1557,6 +1808,7 @@ void Map::LoadTmxTileset(const XMLElement& elem) noexcept {
             }
         }
     });
+    AnimationScheduler::InvalidateTrackedSprites();
 }
 
 bool Map::LoadFromXML(const XMLElement& elem) {
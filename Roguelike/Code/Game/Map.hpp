@@ -9,6 +9,7 @@
 
 #include "Engine/Renderer/Camera2D.hpp"
 
+#include "Game/AnimationScheduler.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/EntityDefinition.hpp"
 #include "Game/EntityText.hpp"
@@ -16,12 +17,16 @@
 #include "Game/Layer.hpp"
 #include "Game/MapGenerator.hpp"
 #include "Game/Pathfinder.hpp"
+#include "Game/TileRange.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <map>
 #include <memory>
 #include <queue>
 #include <set>
+#include <span>
 #include <stack>
 #include <utility>
 #include <vector>
@@ -51,6 +56,7 @@ class Map {
 public:
     constexpr static inline int max_dimension = 255;
 
+    //Collects every traversed tile. Allocates per tile; intended for debug drawing.
     struct RaycastResult2D {
         bool didImpact{false};
         Vector2 impactPosition{};
@@ -59,6 +65,22 @@ public:
         Vector2 impactSurfaceNormal{};
     };
 
+    //Hit information only. Never allocates.
+    struct RaycastHit2D {
+        bool didImpact{false};
+        Vector2 impactPosition{};
+        IntVector2 impactTileCoords{};
+        float impactFraction{1.0f};
+        Vector2 impactSurfaceNormal{};
+        std::size_t traversedCount{0u};
+    };
+
+    struct LightingStats {
+        std::size_t tiles_processed{};
+        std::size_t tiles_baked{};
+        std::size_t queue_peak{};
+    };
+
 
     Map() noexcept = default;
     explicit Map(IntVector2 dimensions) noexcept;
@@ -73,11 +95,13 @@ public:
     void BeginFrame();
     void Update(TimeUtils::FPSeconds deltaSeconds);
     void FocusCameraOnPlayer(TimeUtils::FPSeconds deltaSeconds) noexcept;
+    void UpdateAnimations(TimeUtils::FPSeconds deltaSeconds) noexcept;
     void UpdateLayers(TimeUtils::FPSeconds deltaSeconds);
     void UpdateCursor(TimeUtils::FPSeconds deltaSeconds) noexcept;
     void AddCursorToTopLayer() noexcept;
     void SetPriorityLayer(std::size_t i);
     void Render() const;
+    void Record(RenderRecorder& recorder) const noexcept;
     void DebugRender() const;
     void EndFrame();
 
@@ -126,8 +150,10 @@ public:
     void FocusTileAt(const IntVector3& position);
     void FocusEntity(const Entity* entity);
 
-    RaycastResult2D HasLineOfSight(const Vector2& startPosition, const Vector2& endPosition) const;
-    RaycastResult2D HasLineOfSight(const Vector2& startPosition, const Vector2& direction, float maxDistance) const;
+    RaycastHit2D HasLineOfSight(const Vector2& startPosition, const Vector2& endPosition) const;
+    RaycastHit2D HasLineOfSight(const Vector2& startPosition, const Vector2& direction, float maxDistance) const;
+    void HasLineOfSight(const Vector2& startPosition, std::span<const Vector2> endPositions, std::span<RaycastHit2D> results, std::size_t layerIndex = 0u) const noexcept;
+    const AnimationScheduler& GetAnimationScheduler() const noexcept;
     bool IsTileWithinDistance(const Tile& startTile, unsigned int manhattanDist) const;
 
     bool IsTileWithinDistance(const Tile& startTile, float dist) const;
@@ -138,41 +164,37 @@ public:
     std::vector<Tile*> GetVisibleTilesWithinDistance(const Tile& startTile, float dist) const;
     std::vector<Tile*> GetVisibleTilesWithinDistance(const Tile& startTile, unsigned int manhattanDist) const;
     std::vector<Tile*> GetViewableTiles() const noexcept;
+    TileRange GetTilesInRadius(const IntVector2& center, float radius, TileDistanceMetric metric, std::size_t layerIndex = 0u) const noexcept;
 
+    //The predicate must never return less than the larger of the x and y distances between
+    //the two coordinates (Manhattan, Euclidean and squared Euclidean all qualify), so only
+    //the bounding box of the distance needs to be searched.
     template<typename Pr>
     std::vector<Tile*> GetTilesWithinDistance(const Tile& startTile, float distance, Pr&& predicate) const {
-        auto* layer0 = GetLayer(0);
-        if(!layer0) {
-            return {};
-        }
         const auto& start_coords = startTile.GetCoords();
         std::vector<Tile*> results;
-        for(auto& tile : *layer0) {
-            const auto& end_coords = tile.GetCoords();
-            if(std::invoke(std::forward<Pr>(predicate), start_coords, end_coords) < distance) {
+        ForEachTileInBounds(start_coords, distance, [&](Tile& tile) {
+            if(std::invoke(predicate, start_coords, tile.GetCoords()) < distance) {
                 results.push_back(&tile);
             }
-        }
+        });
         return results;
     }
 
+    //See GetTilesWithinDistance for the requirements on the predicate.
     template<typename Pr>
     std::vector<Tile*> GetTilesAtDistance(const Tile& startTile, float distance, Pr&& predicate) const {
-        auto* layer0 = GetLayer(0);
-        if(!layer0) {
-            return {};
-        }
         const auto& start_coords = startTile.GetCoords();
         std::vector<Tile*> results;
-        for(auto& tile : *layer0) {
+        ForEachTileInBounds(start_coords, distance, [&](Tile& tile) {
             const auto& end_coords = tile.GetCoords();
-            const auto predicateResult = std::invoke(std::forward<Pr>(predicate), start_coords, end_coords);
+            const auto predicateResult = std::invoke(predicate, start_coords, end_coords);
             const bool pLessD = predicateResult < distance;
             const bool dLessP = distance < predicateResult;
             if(!pLessD && !dLessP) {
                 results.push_back(&tile);
             }
-        }
+        });
         return results;
     }
 
@@ -189,22 +211,23 @@ public:
 
 
     //************************************
-    // Method:    Raycast
-    // FullName:  Map::Raycast
+    // Method:    TraverseRay
+    // FullName:  Map::TraverseRay
     // Access:    public 
-    // Returns:   Map::RaycastResult2D
+    // Returns:   Map::RaycastHit2D
     // Qualifier: const
     // Parameter: const Vector2& startPosition: The start position in world units.
     // Parameter: const Vector2& direction: The direction of the ray.
     // Parameter: float maxDistance: The maximum distance in world units.
+    // Parameter: bool ignoreSelf: Ignore the initial tile.
     // Parameter: Pr predicate: A predicate function that takes an IntVector2 as an argument, representing the tile coordinate of the current tile, and returns a bool.
     //     The predicate shall return true on impact.
+    // Parameter: Visitor visitor: A function that takes an IntVector2 as an argument and is called once for every traversed tile, in order, including the impacted tile.
     //************************************
-    template<typename Pr>
-    RaycastResult2D Raycast(const Vector2& startPosition, const Vector2& direction, float maxDistance, bool ignoreSelf, Pr&& predicate) const {
+    template<typename Pr, typename Visitor>
+    RaycastHit2D TraverseRay(const Vector2& startPosition, const Vector2& direction, float maxDistance, bool ignoreSelf, Pr&& predicate, Visitor&& visitor) const {
         const auto endPosition = startPosition + (direction * maxDistance);
         IntVector2 currentTileCoords{startPosition};
-        IntVector2 endTileCoords{endPosition};
 
         const auto D = endPosition - startPosition;
 
@@ -238,30 +261,37 @@ public:
         float firstVerticalIntersectionY = static_cast<float>(currentTileCoords.y + offsetToLeadingEdgeY);
         float tOfNextYCrossing = std::abs(firstVerticalIntersectionY - startPosition.y) * tDeltaY;
 
-        Map::RaycastResult2D result;
-        if(!ignoreSelf && std::invoke(std::forward<Pr>(predicate), currentTileCoords)) {
+        const auto visit = [&](const IntVector2& tileCoords, RaycastHit2D& hit) {
+            ++hit.traversedCount;
+            std::invoke(visitor, tileCoords);
+        };
+
+        Map::RaycastHit2D result;
+        if(!ignoreSelf && std::invoke(predicate, currentTileCoords)) {
             result.didImpact = true;
             result.impactFraction = 0.0f;
             result.impactPosition = startPosition;
-            result.impactTileCoords.insert(currentTileCoords);
+            result.impactTileCoords = currentTileCoords;
             result.impactSurfaceNormal = -direction;
+            visit(currentTileCoords, result);
             return result;
         }
 
         while(true) {
-            result.impactTileCoords.insert(currentTileCoords);
+            visit(currentTileCoords, result);
             if(tOfNextXCrossing < tOfNextYCrossing) {
                 if(tOfNextXCrossing > 1.0f) {
                     result.didImpact = false;
                     return result;
                 }
                 currentTileCoords.x += tileStepX;
-                if(std::invoke(std::forward<Pr>(predicate), currentTileCoords)) {
+                if(std::invoke(predicate, currentTileCoords)) {
                     result.didImpact = true;
                     result.impactFraction = tOfNextXCrossing;
                     result.impactPosition = startPosition + (D * result.impactFraction);
-                    result.impactTileCoords.insert(currentTileCoords);
+                    result.impactTileCoords = currentTileCoords;
                     result.impactSurfaceNormal = Vector2(static_cast<float>(-tileStepX), 0.0f);
+                    visit(currentTileCoords, result);
                     return result;
                 }
                 tOfNextXCrossing += tDeltaX;
@@ -271,12 +301,13 @@ public:
                     return result;
                 }
                 currentTileCoords.y += tileStepY;
-                if(std::invoke(std::forward<Pr>(predicate), currentTileCoords)) {
+                if(std::invoke(predicate, currentTileCoords)) {
                     result.didImpact = true;
                     result.impactFraction = tOfNextYCrossing;
                     result.impactPosition = startPosition + (D * result.impactFraction);
-                    result.impactTileCoords.insert(currentTileCoords);
+                    result.impactTileCoords = currentTileCoords;
                     result.impactSurfaceNormal = Vector2(0.0f, static_cast<float>(-tileStepY));
+                    visit(currentTileCoords, result);
                     return result;
                 }
                 tOfNextYCrossing += tDeltaY;
@@ -285,6 +316,73 @@ public:
         return result;
     }
 
+    //************************************
+    // Method:    RaycastHit
+    // FullName:  Map::RaycastHit
+    // Access:    public 
+    // Returns:   Map::RaycastHit2D
+    // Qualifier: const
+    // Parameter: const Vector2& startPosition: The start position in world units.
+    // Parameter: const Vector2& direction: The direction of the ray.
+    // Parameter: float maxDistance: The maximum distance in world units.
+    // Parameter: bool ignoreSelf: Ignore the initial tile.
+    // Parameter: Pr predicate: A predicate function that takes an IntVector2 as an argument, representing the tile coordinate of the current tile, and returns a bool.
+    //     The predicate shall return true on impact.
+    //************************************
+    template<typename Pr>
+    RaycastHit2D RaycastHit(const Vector2& startPosition, const Vector2& direction, float maxDistance, bool ignoreSelf, Pr&& predicate) const {
+        return TraverseRay(startPosition, direction, maxDistance, ignoreSelf, std::forward<Pr>(predicate), [](const IntVector2&) {});
+    }
+
+    //************************************
+    // Method:    Raycast
+    // FullName:  Map::Raycast
+    // Access:    public 
+    // Returns:   Map::RaycastHit2D
+    // Qualifier: const
+    // Parameter: const Vector2& startPosition: The start position in world units.
+    // Parameter: const Vector2& direction: The direction of the ray.
+    // Parameter: float maxDistance: The maximum distance in world units.
+    // Parameter: bool ignoreSelf: Ignore the initial tile.
+    // Parameter: Pr predicate: A predicate function that takes an IntVector2 as an argument, representing the tile coordinate of the current tile, and returns a bool.
+    //     The predicate shall return true on impact.
+    // Parameter: std::span<IntVector2> traversed: Receives the traversed tiles in order. Tiles past the end of the span are counted but not written;
+    //     traversedCount greater than traversed.size() means the output was truncated.
+    //************************************
+    template<typename Pr>
+    RaycastHit2D Raycast(const Vector2& startPosition, const Vector2& direction, float maxDistance, bool ignoreSelf, Pr&& predicate, std::span<IntVector2> traversed) const {
+        std::size_t written{0u};
+        return TraverseRay(startPosition, direction, maxDistance, ignoreSelf, std::forward<Pr>(predicate), [&](const IntVector2& tileCoords) {
+            if(written < traversed.size()) {
+                traversed[written++] = tileCoords;
+            }
+        });
+    }
+
+    //************************************
+    // Method:    Raycast
+    // FullName:  Map::Raycast
+    // Access:    public 
+    // Returns:   Map::RaycastResult2D
+    // Qualifier: const
+    // Parameter: const Vector2& startPosition: The start position in world units.
+    // Parameter: const Vector2& direction: The direction of the ray.
+    // Parameter: float maxDistance: The maximum distance in world units.
+    // Parameter: bool ignoreSelf: Ignore the initial tile.
+    // Parameter: Pr predicate: A predicate function that takes an IntVector2 as an argument, representing the tile coordinate of the current tile, and returns a bool.
+    //     The predicate shall return true on impact.
+    //************************************
+    template<typename Pr>
+    RaycastResult2D Raycast(const Vector2& startPosition, const Vector2& direction, float maxDistance, bool ignoreSelf, Pr&& predicate) const {
+        Map::RaycastResult2D result;
+        const auto hit = TraverseRay(startPosition, direction, maxDistance, ignoreSelf, std::forward<Pr>(predicate), [&result](const IntVector2& tileCoords) { result.impactTileCoords.insert(tileCoords); });
+        result.didImpact = hit.didImpact;
+        result.impactPosition = hit.impactPosition;
+        result.impactFraction = hit.impactFraction;
+        result.impactSurfaceNormal = hit.impactSurfaceNormal;
+        return result;
+    }
+
     //************************************
     // Method:    Raycast
     // FullName:  Map::Raycast
@@ -312,6 +410,7 @@ public:
     void SetTileMaterial(Material* material);
     void ResetTileMaterial();
     std::size_t GetLayerCount() const;
+    IntVector2 GetChunkDimensions() const noexcept;
     Layer* GetLayer(std::size_t index) const;
     std::optional<std::vector<Tile*>> GetTiles(std::size_t index) const noexcept;
     std::optional<std::vector<Tile*>> GetTiles(const IntVector2& location) const;
@@ -354,6 +453,23 @@ public:
 
     std::size_t DebugTilesInViewCount() const;
     std::size_t DebugVisibleTilesInViewCount() const;
+    std::size_t DebugChunksRebuiltCount() const;
+    TimeUtils::FPMilliseconds DebugChunkBuildTime() const;
+    QuadBatcher::Stats DebugTerrainBatchStats() const;
+    QuadBatcher::Stats DebugDynamicBatchStats() const;
+    MeshBuilderPool::Stats DebugBuilderPoolStats() const;
+    void SetParallelChunkBuilds(bool parallel) noexcept;
+    std::size_t DebugTileInstanceCount() const;
+    std::size_t DebugTileInstanceBytes() const;
+    TimeUtils::FPMilliseconds DebugTileInstanceBuildTime() const;
+    void SetBuildTileInstances(bool build) noexcept;
+    std::size_t DebugTileVertexQuadCount() const;
+    std::size_t DebugTileVertexBytes() const;
+    TimeUtils::FPMilliseconds DebugTileVertexBuildTime() const;
+    void SetBuildTileVertices(bool build) noexcept;
+    //Off for maps driven without a window, such as the scripted frame runner; the mouse cursor and stat window are left alone.
+    void SetCursorUpdatesEnabled(bool enabled) noexcept;
+    const std::filesystem::path& GetFilepath() const noexcept;
 
     void GenerateMap(const XMLElement& elem) noexcept;
     void RegenerateMap() noexcept;
@@ -362,11 +478,31 @@ public:
     Pathfinder* GetPathfinder() noexcept;
     
     void DirtyTileLight(TileInfo& ti) noexcept;
+    const LightingStats& GetLightingStats() const noexcept;
+    void ResetLightingStats() noexcept;
+    void UpdateSkyLightColumn(const Tile& changedTile) noexcept;
+    void OnOpacityChanged(const Layer& layer, const IntVector2& tile_coords) noexcept;
 
     MapGenerator _map_generator;
 
 protected:
 private:
+    template<typename Fn>
+    void ForEachTileInBounds(const IntVector2& center, float distance, Fn&& fn) const {
+        auto* layer0 = GetLayer(0);
+        if(!layer0 || distance < 0.0f) {
+            return;
+        }
+        const auto extent = static_cast<int>(std::ceil(distance));
+        const auto mins = IntVector2{(std::max)(0, center.x - extent), (std::max)(0, center.y - extent)};
+        const auto maxs = IntVector2{(std::min)(layer0->tileDimensions.x - 1, center.x + extent), (std::min)(layer0->tileDimensions.y - 1, center.y + extent)};
+        for(int y = mins.y; y <= maxs.y; ++y) {
+            for(int x = mins.x; x <= maxs.x; ++x) {
+                std::invoke(fn, *layer0->GetTile(static_cast<std::size_t>(x), static_cast<std::size_t>(y)));
+            }
+        }
+    }
+
     void Initialize(const XMLElement& elem) noexcept;
     void SetParentAdventure(Adventure* parent) noexcept;
 
@@ -386,6 +522,12 @@ private:
     bool AllowLightingDuringDay() const noexcept;
     void InitializeLighting(Layer* layer) noexcept;
     void CalculateLighting(Layer* layer) noexcept;
+    void CalculateSkyLight(Layer* layer) noexcept;
+    bool IsTileOpenToSky(const Tile& tile, std::size_t voidDefinitionId) const noexcept;
+    void BakeStaticLighting(Layer* layer) noexcept;
+    void DirtyDynamicLightSources(Layer* layer) noexcept;
+    void DirtyStaticLightForLayers() noexcept;
+    uint32_t CalculateStaticLightSourceValue(const TileInfo& ti) const noexcept;
     void DirtyValidNeighbors(TileInfo& ti) noexcept;
     void DirtyCardinalNeighbors(TileInfo& ti) noexcept;
     void UpdateTileLighting(TileInfo& ti) noexcept;
@@ -424,6 +566,8 @@ private:
     std::filesystem::path m_filepath{};
     std::vector<std::shared_ptr<Layer>> _layers{};
     std::deque<TileInfo> _lightingQueue{};
+    LightingStats _lighting_stats{};
+    AnimationScheduler _animation_scheduler{};
     std::shared_ptr<tinyxml2::XMLDocument> _xml_doc{};
     XMLElement* _root_xml_element{};
     Adventure* _parent_adventure{};
@@ -443,6 +587,7 @@ private:
     mutable std::size_t _debug_visible_tiles_in_view_count{};
     static inline unsigned long long default_map_index = 0ull;
     bool _should_render_stat_window{false};
+    bool _cursor_updates_enabled{true};
     bool _allow_lighting_calculations_during_day{true};
     bool m_isInfinite{ false };
     uint16_t m_chunkWidth{ 16u };
@@ -456,6 +601,7 @@ private:
     friend class RoomsAndCorridorsMapGenerator;
     friend class Adventure;
     friend class Game;
+    friend class LightingHarness;
     friend class MapEditor;
     friend class TmxReader;
     friend class TsxReader;
@@ -0,0 +1,65 @@
+#include "Game/MeshBuilderPool.hpp"
+
+#include <algorithm>
+
+MeshBuilderPool::Handle MeshBuilderPool::Acquire() noexcept {
+    ++_stats.in_use;
+    if(!_free.empty()) {
+        const auto handle = _free.back();
+        _free.pop_back();
+        return handle;
+    }
+    _entries.emplace_back();
+    _stats.builders = _entries.size();
+    return _entries.size() - 1u;
+}
+
+//The builder keeps its storage for whoever acquires it next.
+void MeshBuilderPool::Release(Handle handle) noexcept {
+    if(handle >= _entries.size()) {
+        return;
+    }
+    Clear(handle);
+    _free.push_back(handle);
+    --_stats.in_use;
+}
+
+const Mesh::Builder& MeshBuilderPool::Get(Handle handle) const noexcept {
+    return _entries[handle].builder;
+}
+
+Mesh::Builder& MeshBuilderPool::Get(Handle handle) noexcept {
+    return const_cast<Mesh::Builder&>(static_cast<const MeshBuilderPool&>(*this).Get(handle));
+}
+
+//Storage that grew since the last clear means the build that filled it reallocated, and
+//restoring storage the clear gave back is another allocation. Both are counted, so once
+//every builder has reached its peak the counter only moves if clearing frees storage.
+void MeshBuilderPool::Clear(Handle handle) noexcept {
+    if(handle >= _entries.size()) {
+        return;
+    }
+    auto& entry = _entries[handle];
+    auto& builder = entry.builder;
+    if(builder.verticies.capacity() > entry.vertex_capacity) {
+        ++_stats.reallocations;
+    }
+    if(builder.indicies.capacity() > entry.index_capacity) {
+        ++_stats.reallocations;
+    }
+    entry.vertex_capacity = (std::max)(entry.vertex_capacity, builder.verticies.capacity());
+    entry.index_capacity = (std::max)(entry.index_capacity, builder.indicies.capacity());
+    builder.Clear();
+    if(builder.verticies.capacity() < entry.vertex_capacity) {
+        builder.verticies.reserve(entry.vertex_capacity);
+        ++_stats.reallocations;
+    }
+    if(builder.indicies.capacity() < entry.index_capacity) {
+        builder.indicies.reserve(entry.index_capacity);
+        ++_stats.reallocations;
+    }
+}
+
+const MeshBuilderPool::Stats& MeshBuilderPool::GetStats() const noexcept {
+    return _stats;
+}
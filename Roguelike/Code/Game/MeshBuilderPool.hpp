@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Engine/Renderer/Mesh.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <vector>
+
+//Owns mesh builders that are reused instead of destroyed, so their vertex and
+//index storage stays at the largest size each one has needed. Handles stay valid
+//until released; builders never move once created.
+class MeshBuilderPool {
+public:
+    using Handle = std::size_t;
+    static constexpr Handle invalid_handle = (std::numeric_limits<Handle>::max)();
+
+    struct Stats {
+        std::size_t builders{};
+        std::size_t in_use{};
+        std::size_t reallocations{};
+    };
+
+    MeshBuilderPool() = default;
+    MeshBuilderPool(const MeshBuilderPool& other) = default;
+    MeshBuilderPool(MeshBuilderPool&& other) = default;
+    MeshBuilderPool& operator=(const MeshBuilderPool& other) = default;
+    MeshBuilderPool& operator=(MeshBuilderPool&& other) = default;
+    ~MeshBuilderPool() = default;
+
+    Handle Acquire() noexcept;
+    void Release(Handle handle) noexcept;
+
+    const Mesh::Builder& Get(Handle handle) const noexcept;
+    Mesh::Builder& Get(Handle handle) noexcept;
+
+    //Empties the builder but keeps its storage. Not safe to call while another thread builds into the pool.
+    void Clear(Handle handle) noexcept;
+
+    const Stats& GetStats() const noexcept;
+
+protected:
+private:
+    struct Entry {
+        Mesh::Builder builder{};
+        std::size_t vertex_capacity{};
+        std::size_t index_capacity{};
+    };
+
+    std::deque<Entry> _entries{};
+    std::vector<Handle> _free{};
+    Stats _stats{};
+};
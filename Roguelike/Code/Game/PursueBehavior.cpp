@@ -43,7 +43,19 @@ void PursueBehavior::SetTarget(Actor* target) noexcept {
     InitializePathfinding();
 }
 
+//Chases the target while the actor can see it, then heads for where it was last seen.
 void PursueBehavior::Act(Actor* actor) noexcept {
+    const auto* target = GetTarget();
+    if(target == nullptr) {
+        return;
+    }
+    if(actor->CanSee(*target)) {
+        _last_seen_position = target->GetPosition();
+        _has_last_seen_position = true;
+    } else if(!_has_last_seen_position || actor->GetPosition() == _last_seen_position) {
+        _has_last_seen_position = false;
+        return;
+    }
     const auto viable = [this, actor](const IntVector2& a)->bool {
         const auto coords = IntVector3{a, 0};
         const auto* map = actor->map;
@@ -58,8 +70,7 @@ void PursueBehavior::Act(Actor* actor) noexcept {
         return MathUtils::CalcDistance(va, vb);
     };
     const auto& my_loc = actor->GetPosition();
-    const auto& target_loc = GetTarget()->GetPosition();
-    pather->AStar(my_loc, target_loc, viable, h, d);
+    pather->AStar(my_loc, _last_seen_position, viable, h, d);
     const auto path = pather->GetResult();
     for(auto& node : path) {
         const auto coords = IntVector3{node->coords, 0};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Engine/Math/IntVector2.hpp"
+
 #include "Game/Behavior.hpp"
 
 class Pathfinder;
@@ -21,6 +23,8 @@ protected:
 private:
 
     Pathfinder* pather{};
+    IntVector2 _last_seen_position{};
+    bool _has_last_seen_position{false};
 
     friend class ActorCommand;
     friend class MoveDownActorCommand;
@@ -0,0 +1,134 @@
+#include "Game/QuadBatcher.hpp"
+
+#include "Engine/Renderer/Vertex3D.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+QuadBatcher::Stats& QuadBatcher::Stats::operator+=(const Stats& rhs) noexcept {
+    quads += rhs.quads;
+    draw_ranges += rhs.draw_ranges;
+    unbatched_draw_ranges += rhs.unbatched_draw_ranges;
+    vertices += rhs.vertices;
+    indices += rhs.indices;
+    return *this;
+}
+
+void QuadBatcher::SetDrawOrder(DrawOrder order, uint32_t sub_order /*= 0u*/) noexcept {
+    _order = (static_cast<uint32_t>(order) << 8u) | (sub_order & 0xFFu);
+}
+
+void QuadBatcher::SetDrawOrder(uint32_t order) noexcept {
+    _order = order;
+}
+
+uint32_t QuadBatcher::GetDrawOrder() const noexcept {
+    return _order;
+}
+
+void QuadBatcher::AddQuad(const std::array<Vector3, 4>& positions, const std::array<Vector2, 4>& uvs, const std::array<Rgba, 4>& colors, Material* material) noexcept {
+    _quads.push_back(Quad{positions, uvs, colors, material, _order, GetMaterialRank(material), static_cast<uint32_t>(_quads.size())});
+}
+
+//Containers keep their capacity, so a steady frame does not allocate.
+void QuadBatcher::Clear() noexcept {
+    _quads.clear();
+    _sorted_quads.clear();
+    _ranges.clear();
+    _materials.clear();
+    _stats = Stats{};
+    _order = 0u;
+}
+
+//Materials are ranked by first use rather than by address so the output is the same every run.
+void QuadBatcher::Sort() noexcept {
+    _sort_indices.resize(_quads.size());
+    std::iota(std::begin(_sort_indices), std::end(_sort_indices), uint32_t{0u});
+    std::sort(std::begin(_sort_indices), std::end(_sort_indices), [this](uint32_t a, uint32_t b) {
+        const auto& lhs = _quads[a];
+        const auto& rhs = _quads[b];
+        return std::tie(lhs.order, lhs.material_rank, lhs.sequence) < std::tie(rhs.order, rhs.material_rank, rhs.sequence);
+    });
+    _sorted_quads.clear();
+    _ranges.clear();
+    for(const auto index : _sort_indices) {
+        const auto& quad = _quads[index];
+        if(_ranges.empty() || _ranges.back().material != quad.material) {
+            _ranges.push_back(Range{quad.material, _sorted_quads.size(), 0u});
+        }
+        ++_ranges.back().count;
+        _sorted_quads.push_back(quad);
+    }
+    _stats.quads = _quads.size();
+    _stats.draw_ranges = _ranges.size();
+    _stats.unbatched_draw_ranges = 0u;
+    for(auto i = std::size_t{0u}; i != _quads.size(); ++i) {
+        if(i == 0u || _quads[i].material != _quads[i - 1u].material) {
+            ++_stats.unbatched_draw_ranges;
+        }
+    }
+    _stats.vertices = _quads.size() * 4u;
+    _stats.indices = _quads.size() * 6u;
+}
+
+void QuadBatcher::Flush(Mesh::Builder& builder) noexcept {
+    Sort();
+    builder.verticies.reserve(builder.verticies.size() + _stats.vertices);
+    builder.indicies.reserve(builder.indicies.size() + _stats.indices);
+    for(const auto& range : _ranges) {
+        AppendQuads(builder, std::span<const Quad>{_sorted_quads}.subspan(range.first, range.count), range.material);
+    }
+}
+
+//Grows the builder's vertex and index storage once for the whole range and writes
+//through spans, instead of pushing each corner and index one at a time.
+//Indices follow Mesh::Builder::Primitive::Quad: bottom-left, top-left, top-right, then bottom-left, top-right, bottom-right.
+void QuadBatcher::AppendQuads(Mesh::Builder& builder, std::span<const Quad> quads, Material* material) noexcept {
+    if(quads.empty()) {
+        return;
+    }
+    using Vertex = decltype(builder.verticies)::value_type;
+    using Index = decltype(builder.indicies)::value_type;
+    static constexpr std::array<std::size_t, 6> quad_indices{0u, 1u, 2u, 0u, 2u, 3u};
+    const auto first_vertex = builder.verticies.size();
+    const auto first_index = builder.indicies.size();
+    const auto normal = -Vector3::Z_Axis;
+    builder.Begin(PrimitiveType::Triangles);
+    builder.verticies.resize(first_vertex + quads.size() * 4u);
+    builder.indicies.resize(first_index + quads.size() * quad_indices.size());
+    const auto vertices = std::span<Vertex>{builder.verticies}.subspan(first_vertex);
+    const auto indices = std::span<Index>{builder.indicies}.subspan(first_index);
+    for(auto i = std::size_t{0u}; i != quads.size(); ++i) {
+        const auto& quad = quads[i];
+        for(auto corner = std::size_t{0u}; corner != quad.positions.size(); ++corner) {
+            vertices[i * 4u + corner] = Vertex{quad.positions[corner], quad.colors[corner], quad.uvs[corner], normal};
+        }
+        const auto base = first_vertex + i * 4u;
+        for(auto k = std::size_t{0u}; k != quad_indices.size(); ++k) {
+            indices[i * quad_indices.size() + k] = static_cast<Index>(base + quad_indices[k]);
+        }
+    }
+    builder.End(material);
+}
+
+std::span<const QuadBatcher::Quad> QuadBatcher::GetSortedQuads() const noexcept {
+    return _sorted_quads;
+}
+
+std::span<const QuadBatcher::Range> QuadBatcher::GetRanges() const noexcept {
+    return _ranges;
+}
+
+const QuadBatcher::Stats& QuadBatcher::GetStats() const noexcept {
+    return _stats;
+}
+
+uint32_t QuadBatcher::GetMaterialRank(Material* material) noexcept {
+    const auto found = std::find(std::begin(_materials), std::end(_materials), material);
+    if(found != std::end(_materials)) {
+        return static_cast<uint32_t>(std::distance(std::begin(_materials), found));
+    }
+    _materials.push_back(material);
+    return static_cast<uint32_t>(_materials.size() - 1u);
+}
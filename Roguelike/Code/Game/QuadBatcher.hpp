@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Engine/Core/Rgba.hpp"
+
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Math/Vector3.hpp"
+
+#include "Engine/Renderer/Mesh.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class Material;
+
+//Collects textured quads and emits them grouped by material.
+//Quads are ordered by draw order first, so layering such as equipment over
+//actors survives the grouping; within a draw order, quads that share a
+//material become one draw range and otherwise keep their submission order.
+class QuadBatcher {
+public:
+    enum class DrawOrder : uint32_t {
+        Terrain
+        ,Feature
+        ,Item
+        ,Cape
+        ,Actor
+        ,Equipment
+    };
+
+    struct Quad {
+        std::array<Vector3, 4> positions{};
+        std::array<Vector2, 4> uvs{};
+        std::array<Rgba, 4> colors{};
+        Material* material{};
+        uint32_t order{};
+        uint32_t material_rank{};
+        uint32_t sequence{};
+    };
+
+    struct Range {
+        Material* material{};
+        std::size_t first{};
+        std::size_t count{};
+    };
+
+    struct Stats {
+        std::size_t quads{};
+        std::size_t draw_ranges{};
+        std::size_t unbatched_draw_ranges{};
+        std::size_t vertices{};
+        std::size_t indices{};
+
+        Stats& operator+=(const Stats& rhs) noexcept;
+    };
+
+    void SetDrawOrder(DrawOrder order, uint32_t sub_order = 0u) noexcept;
+    void SetDrawOrder(uint32_t order) noexcept;
+    uint32_t GetDrawOrder() const noexcept;
+
+    //Corners are in bottom-left, top-left, top-right, bottom-right order.
+    void AddQuad(const std::array<Vector3, 4>& positions, const std::array<Vector2, 4>& uvs, const std::array<Rgba, 4>& colors, Material* material) noexcept;
+    void Clear() noexcept;
+
+    void Sort() noexcept;
+    void Flush(Mesh::Builder& builder) noexcept;
+
+    //Appends the quads as one draw range, written straight into the builder's storage. Flush reserves for every range up front.
+    static void AppendQuads(Mesh::Builder& builder, std::span<const Quad> quads, Material* material) noexcept;
+
+    std::span<const Quad> GetSortedQuads() const noexcept;
+    std::span<const Range> GetRanges() const noexcept;
+    const Stats& GetStats() const noexcept;
+
+protected:
+private:
+    uint32_t GetMaterialRank(Material* material) noexcept;
+
+    std::vector<Quad> _quads{};
+    std::vector<Quad> _sorted_quads{};
+    std::vector<uint32_t> _sort_indices{};
+    std::vector<Range> _ranges{};
+    std::vector<Material*> _materials{};
+    Stats _stats{};
+    uint32_t _order{0u};
+};
@@ -0,0 +1,137 @@
+#include "Game/RaycastBatch.hpp"
+
+#include "Engine/Math/IntVector2.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include "Game/BitGrid.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include <emmintrin.h>
+
+void RaycastBatch::Cast(const BitGrid& opacity, const Vector2& startPosition, std::span<const Vector2> endPositions, std::span<Map::RaycastHit2D> results) noexcept {
+    const auto count = (std::min)(endPositions.size(), results.size());
+    for(auto first = std::size_t{0u}; first < count; first += lane_count) {
+        const auto lanes = (std::min)(lane_count, count - first);
+        CastLanes(opacity, startPosition, endPositions.subspan(first, lanes), results.subspan(first, lanes));
+    }
+}
+
+void RaycastBatch::CastLanes(const BitGrid& opacity, const Vector2& startPosition, std::span<const Vector2> endPositions, std::span<Map::RaycastHit2D> results) noexcept {
+    alignas(16) std::array<float, lane_count> tOfNextXCrossing{2.0f, 2.0f, 2.0f, 2.0f};
+    alignas(16) std::array<float, lane_count> tOfNextYCrossing{2.0f, 2.0f, 2.0f, 2.0f};
+    alignas(16) std::array<float, lane_count> tDeltaX{};
+    alignas(16) std::array<float, lane_count> tDeltaY{};
+    alignas(16) std::array<int32_t, lane_count> tileStepX{};
+    alignas(16) std::array<int32_t, lane_count> tileStepY{};
+    alignas(16) std::array<int32_t, lane_count> laneMask{};
+    std::array<Vector2, lane_count> displacement{};
+
+    const IntVector2 startTileCoords{startPosition};
+    //Same setup as Map::TraverseRay so both walks cross tile edges at identical t.
+    for(auto lane = std::size_t{0u}; lane != endPositions.size(); ++lane) {
+        const auto D = endPositions[lane] - startPosition;
+        displacement[lane] = D;
+        tDeltaX[lane] = MathUtils::IsEquivalent(D.x, 0.0f) ? (std::numeric_limits<float>::max)() : 1.0f / std::abs(D.x);
+        tDeltaY[lane] = MathUtils::IsEquivalent(D.y, 0.0f) ? (std::numeric_limits<float>::max)() : 1.0f / std::abs(D.y);
+        tileStepX[lane] = D.x > 0 ? 1 : (D.x < 0 ? -1 : 0);
+        tileStepY[lane] = D.y > 0 ? 1 : (D.y < 0 ? -1 : 0);
+        const auto firstVerticalIntersectionX = static_cast<float>(startTileCoords.x + (tileStepX[lane] + 1) / 2);
+        const auto firstVerticalIntersectionY = static_cast<float>(startTileCoords.y + (tileStepY[lane] + 1) / 2);
+        tOfNextXCrossing[lane] = std::abs(firstVerticalIntersectionX - startPosition.x) * tDeltaX[lane];
+        tOfNextYCrossing[lane] = std::abs(firstVerticalIntersectionY - startPosition.y) * tDeltaY[lane];
+        laneMask[lane] = -1;
+        results[lane] = Map::RaycastHit2D{};
+    }
+
+    __m128 tMaxX = _mm_load_ps(tOfNextXCrossing.data());
+    __m128 tMaxY = _mm_load_ps(tOfNextYCrossing.data());
+    const __m128 tDeltaX4 = _mm_load_ps(tDeltaX.data());
+    const __m128 tDeltaY4 = _mm_load_ps(tDeltaY.data());
+    const __m128i stepX4 = _mm_load_si128(reinterpret_cast<const __m128i*>(tileStepX.data()));
+    const __m128i stepY4 = _mm_load_si128(reinterpret_cast<const __m128i*>(tileStepY.data()));
+    __m128i tileX4 = _mm_set1_epi32(startTileCoords.x);
+    __m128i tileY4 = _mm_set1_epi32(startTileCoords.y);
+    __m128i active = _mm_load_si128(reinterpret_cast<const __m128i*>(laneMask.data()));
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    const auto words = opacity.GetWords();
+    const auto& dimensions = opacity.GetDimensions();
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lastX = _mm_set1_epi32(dimensions.x - 1);
+    const __m128i lastY = _mm_set1_epi32(dimensions.y - 1);
+    const __m128i rowStride = _mm_set1_epi32(1 | (dimensions.x << 16));
+    const __m128i countStep = _mm_set1_epi32(1);
+    __m128i traversed = _mm_set1_epi32(1);
+
+    alignas(16) std::array<int32_t, lane_count> tileIndex{};
+    alignas(16) std::array<int32_t, lane_count> tileX{};
+    alignas(16) std::array<int32_t, lane_count> tileY{};
+    alignas(16) std::array<float, lane_count> tNext{};
+    if(words.empty()) {
+        return;
+    }
+    while(true) {
+        //Ties step along y, as in the scalar walk.
+        const __m128i stepsX = _mm_castps_si128(_mm_cmplt_ps(tMaxX, tMaxY));
+        const __m128 t = _mm_min_ps(tMaxX, tMaxY);
+        active = _mm_andnot_si128(_mm_castps_si128(_mm_cmpgt_ps(t, one)), active);
+        if(_mm_movemask_epi8(active) == 0) {
+            break;
+        }
+        const __m128i xMask = _mm_and_si128(stepsX, active);
+        const __m128i yMask = _mm_andnot_si128(stepsX, active);
+        tileX4 = _mm_add_epi32(tileX4, _mm_and_si128(stepX4, xMask));
+        tileY4 = _mm_add_epi32(tileY4, _mm_and_si128(stepY4, yMask));
+        tMaxX = _mm_add_ps(tMaxX, _mm_and_ps(tDeltaX4, _mm_castsi128_ps(xMask)));
+        tMaxY = _mm_add_ps(tMaxY, _mm_and_ps(tDeltaY4, _mm_castsi128_ps(yMask)));
+        traversed = _mm_add_epi32(traversed, _mm_and_si128(countStep, active));
+
+        //Tiles off the grid are never opaque. Inside the grid, y * width + x comes from one
+        //multiply-add on the packed 16-bit coordinates, and outside lanes read bit zero of word zero.
+        const __m128i inside = _mm_andnot_si128(_mm_or_si128(_mm_or_si128(_mm_cmplt_epi32(tileX4, zero), _mm_cmplt_epi32(tileY4, zero)), _mm_or_si128(_mm_cmpgt_epi32(tileX4, lastX), _mm_cmpgt_epi32(tileY4, lastY))), active);
+        const __m128i packed = _mm_or_si128(tileX4, _mm_slli_epi32(tileY4, 16));
+        const __m128i index4 = _mm_and_si128(_mm_madd_epi16(packed, rowStride), inside);
+        _mm_store_si128(reinterpret_cast<__m128i*>(tileIndex.data()), index4);
+        const int insideBits = _mm_movemask_ps(_mm_castsi128_ps(inside));
+        int hitBits = 0;
+        for(auto lane = std::size_t{0u}; lane != lane_count; ++lane) {
+            const auto index = static_cast<uint32_t>(tileIndex[lane]);
+            hitBits |= static_cast<int>((words[index / BitGrid::bits_per_word] >> (index % BitGrid::bits_per_word)) & BitGrid::word_type{1u}) << lane;
+        }
+        hitBits &= insideBits;
+        if(hitBits == 0) {
+            continue;
+        }
+        _mm_store_si128(reinterpret_cast<__m128i*>(tileX.data()), tileX4);
+        _mm_store_si128(reinterpret_cast<__m128i*>(tileY.data()), tileY4);
+        _mm_store_ps(tNext.data(), t);
+        const int xBits = _mm_movemask_ps(_mm_castsi128_ps(xMask));
+        for(auto lane = std::size_t{0u}; lane != lane_count; ++lane) {
+            if(!(hitBits & (1 << lane))) {
+                continue;
+            }
+            auto& result = results[lane];
+            result.didImpact = true;
+            result.impactFraction = tNext[lane];
+            result.impactPosition = startPosition + (displacement[lane] * tNext[lane]);
+            result.impactTileCoords = IntVector2{tileX[lane], tileY[lane]};
+            if(xBits & (1 << lane)) {
+                result.impactSurfaceNormal = Vector2(static_cast<float>(-tileStepX[lane]), 0.0f);
+            } else {
+                result.impactSurfaceNormal = Vector2(0.0f, static_cast<float>(-tileStepY[lane]));
+            }
+        }
+        const __m128i hitMask = _mm_set_epi32(hitBits & 8 ? -1 : 0, hitBits & 4 ? -1 : 0, hitBits & 2 ? -1 : 0, hitBits & 1 ? -1 : 0);
+        active = _mm_andnot_si128(hitMask, active);
+    }
+
+    alignas(16) std::array<int32_t, lane_count> traversedCount{};
+    _mm_store_si128(reinterpret_cast<__m128i*>(traversedCount.data()), traversed);
+    for(auto lane = std::size_t{0u}; lane != endPositions.size(); ++lane) {
+        results[lane].traversedCount = static_cast<std::size_t>(traversedCount[lane]);
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Engine/Math/Vector2.hpp"
+
+#include "Game/Map.hpp"
+
+#include <span>
+
+class BitGrid;
+
+//Traverses many rays from one origin over an opacity grid, four rays per step.
+//Results match Map::RaycastHit with ignoreSelf set and an opacity predicate.
+class RaycastBatch {
+public:
+    static constexpr std::size_t lane_count = 4u;
+
+    static void Cast(const BitGrid& opacity, const Vector2& startPosition, std::span<const Vector2> endPositions, std::span<Map::RaycastHit2D> results) noexcept;
+
+protected:
+private:
+    static void CastLanes(const BitGrid& opacity, const Vector2& startPosition, std::span<const Vector2> endPositions, std::span<Map::RaycastHit2D> results) noexcept;
+};
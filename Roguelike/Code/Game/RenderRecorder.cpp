@@ -0,0 +1,55 @@
+#include "Game/RenderRecorder.hpp"
+
+void RenderRecorder::BeginFrame() noexcept {
+    _frame_stats = Stats{};
+    _frame_stats.frames = 1u;
+}
+
+void RenderRecorder::EndFrame() noexcept {
+    _total_stats.frames += _frame_stats.frames;
+    _total_stats.mesh_submissions += _frame_stats.mesh_submissions;
+    _total_stats.draw_ranges += _frame_stats.draw_ranges;
+    _total_stats.vertices += _frame_stats.vertices;
+    _total_stats.indices += _frame_stats.indices;
+    _total_stats.material_changes += _frame_stats.material_changes;
+    _total_stats.text_draws += _frame_stats.text_draws;
+    _total_stats.text_characters += _frame_stats.text_characters;
+}
+
+//Each draw instruction would be one draw call with its own material bind.
+void RenderRecorder::SubmitMesh(const Mesh::Builder& builder) noexcept {
+    ++_frame_stats.mesh_submissions;
+    for(const auto& draw_instruction : builder.draw_instructions) {
+        SetMaterial(draw_instruction.material);
+        ++_frame_stats.draw_ranges;
+    }
+    _frame_stats.vertices += builder.verticies.size();
+    _frame_stats.indices += builder.indicies.size();
+}
+
+//Binding the material that is already bound is free, so only changes are counted.
+void RenderRecorder::SetMaterial(const Material* material) noexcept {
+    if(material != _current_material) {
+        _current_material = material;
+        ++_frame_stats.material_changes;
+    }
+}
+
+void RenderRecorder::DrawTextLine(const std::string& text) noexcept {
+    ++_frame_stats.text_draws;
+    _frame_stats.text_characters += text.size();
+}
+
+const RenderRecorder::Stats& RenderRecorder::GetFrameStats() const noexcept {
+    return _frame_stats;
+}
+
+const RenderRecorder::Stats& RenderRecorder::GetTotalStats() const noexcept {
+    return _total_stats;
+}
+
+void RenderRecorder::Reset() noexcept {
+    _frame_stats = Stats{};
+    _total_stats = Stats{};
+    _current_material = nullptr;
+}
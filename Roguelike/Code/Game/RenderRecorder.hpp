@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Engine/Renderer/Mesh.hpp"
+
+#include <string>
+
+class Material;
+
+//Takes the same mesh, material and text submissions the render path makes and counts
+//them instead of drawing. It is not a renderer service; the game's renderer still has to exist.
+class RenderRecorder {
+public:
+    struct Stats {
+        std::size_t frames{};
+        std::size_t mesh_submissions{};
+        std::size_t draw_ranges{};
+        std::size_t vertices{};
+        std::size_t indices{};
+        std::size_t material_changes{};
+        std::size_t text_draws{};
+        std::size_t text_characters{};
+    };
+
+    void BeginFrame() noexcept;
+    void EndFrame() noexcept;
+
+    void SubmitMesh(const Mesh::Builder& builder) noexcept;
+    void SetMaterial(const Material* material) noexcept;
+    void DrawTextLine(const std::string& text) noexcept;
+
+    const Stats& GetFrameStats() const noexcept;
+    const Stats& GetTotalStats() const noexcept;
+    void Reset() noexcept;
+
+protected:
+private:
+    Stats _frame_stats{};
+    Stats _total_stats{};
+    const Material* _current_material{};
+};
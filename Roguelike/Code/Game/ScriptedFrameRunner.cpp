@@ -0,0 +1,137 @@
+#include "Game/ScriptedFrameRunner.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+
+#include "Engine/Services/ServiceLocator.hpp"
+#include "Engine/Services/IFileLoggerService.hpp"
+
+#include "Game/Actor.hpp"
+#include "Game/Map.hpp"
+#include "Game/Tile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <format>
+#include <sstream>
+#include <string_view>
+#include <utility>
+
+bool ScriptedFrameRunner::LoadScript(const std::filesystem::path& src) noexcept {
+    if(const auto buffer = FileUtils::ReadStringBufferFromFile(src); buffer.has_value()) {
+        return ParseScript(*buffer);
+    }
+    return false;
+}
+
+bool ScriptedFrameRunner::ParseScript(const std::string& script) noexcept {
+    _steps.clear();
+    std::istringstream lines{script};
+    std::string line{};
+    while(std::getline(lines, line)) {
+        std::erase(line, '\r');
+        std::istringstream words{line};
+        Step step{};
+        if(!(words >> step.command) || step.command.front() == '#') {
+            continue;
+        }
+        if(step.command == "move" && !(words >> step.direction)) {
+            return false;
+        }
+        if(step.command != "frames" && step.command != "rest" && step.command != "move") {
+            return false;
+        }
+        if(!(words >> step.frames)) {
+            return false;
+        }
+        step.text = line;
+        _steps.push_back(step);
+    }
+    return !_steps.empty();
+}
+
+void ScriptedFrameRunner::Run(Map& map) noexcept {
+    _results.clear();
+    map.SetCursorUpdatesEnabled(false);
+    for(const auto& step : _steps) {
+        RunStep(map, step);
+    }
+    map.SetCursorUpdatesEnabled(true);
+}
+
+void ScriptedFrameRunner::RunStep(Map& map, const Step& step) noexcept {
+    Result result{};
+    result.step = step.text;
+    RenderRecorder recorder{};
+    const auto deltaSeconds = TimeUtils::FPSeconds{frame_seconds};
+    for(auto frame = std::size_t{0u}; frame != step.frames; ++frame) {
+        const auto update_start = std::chrono::steady_clock::now();
+        map.BeginFrame();
+        ApplyPlayerAction(map, step);
+        map.Update(deltaSeconds);
+        const auto record_start = std::chrono::steady_clock::now();
+        recorder.BeginFrame();
+        map.Record(recorder);
+        recorder.EndFrame();
+        const auto record_end = std::chrono::steady_clock::now();
+        map.EndFrame();
+        const auto frame_end = std::chrono::steady_clock::now();
+        result.update_time += TimeUtils::FPMilliseconds{(record_start - update_start) + (frame_end - record_end)};
+        result.record_time += TimeUtils::FPMilliseconds{record_end - record_start};
+    }
+    result.frames = step.frames;
+    result.render_stats = recorder.GetTotalStats();
+    _results.push_back(result);
+}
+
+void ScriptedFrameRunner::ApplyPlayerAction(Map& map, const Step& step) noexcept {
+    auto* player = map.player;
+    if(player == nullptr || player->tile == nullptr) {
+        return;
+    }
+    if(step.command == "rest") {
+        player->Act();
+        return;
+    }
+    if(step.command != "move") {
+        return;
+    }
+    using NeighborGetter = Tile* (Tile::*)() const;
+    static const std::array<std::pair<std::string_view, NeighborGetter>, 8> neighbors{{
+        {"north", &Tile::GetNorthNeighbor}
+        ,{"northeast", &Tile::GetNorthEastNeighbor}
+        ,{"east", &Tile::GetEastNeighbor}
+        ,{"southeast", &Tile::GetSouthEastNeighbor}
+        ,{"south", &Tile::GetSouthNeighbor}
+        ,{"southwest", &Tile::GetSouthWestNeighbor}
+        ,{"west", &Tile::GetWestNeighbor}
+        ,{"northwest", &Tile::GetNorthWestNeighbor}
+    }};
+    for(const auto& [name, get_neighbor] : neighbors) {
+        if(step.direction != name) {
+            continue;
+        }
+        if(auto* destination = (player->tile->*get_neighbor)(); destination) {
+            map.MoveOrAttack(player, destination);
+        }
+        return;
+    }
+}
+
+const std::vector<ScriptedFrameRunner::Result>& ScriptedFrameRunner::GetResults() const noexcept {
+    return _results;
+}
+
+void ScriptedFrameRunner::LogResults() const noexcept {
+    auto* logger = ServiceLocator::get<IFileLoggerService>();
+    for(const auto& r : _results) {
+        const auto frames = static_cast<float>((std::max)(r.frames, std::size_t{1u}));
+        const auto& s = r.render_stats;
+        const auto line = std::format("Frame bench [{0}]: {1} frames, update {2:.3f} ms/frame, record {3:.3f} ms/frame, {4} meshes, {5} draw ranges, {6} material changes, {7} vertices, {8} indices, {9} text draws",
+            r.step, r.frames, r.update_time.count() / frames, r.record_time.count() / frames, s.mesh_submissions, s.draw_ranges, s.material_changes, s.vertices, s.indices, s.text_draws);
+        logger->LogLine(line);
+        DebuggerPrintf(line + '\n');
+    }
+    logger->LogLineAndFlush("Frame bench: done");
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include "Game/RenderRecorder.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class Map;
+
+//Drives map frames from a script inside the running game. Each frame runs the
+//map's BeginFrame, Update and EndFrame at a fixed time step and submits what the
+//layers and text entities would draw to a RenderRecorder, timing both halves.
+//
+//Loading and updating a map still needs the game's renderer and UI system; only
+//drawing, mouse input and the cursor are skipped. It moves the player of whatever
+//map it is given, so give it a map loaded for the run rather than the one being played.
+//
+//Script lines, blank lines and lines starting with # are ignored:
+//    frames <count>                 run frames with no player action
+//    rest <count>                   the player rests once per frame
+//    move <direction> <count>       the player moves or attacks once per frame;
+//                                   direction is north, northeast, east, southeast,
+//                                   south, southwest, west or northwest
+class ScriptedFrameRunner {
+public:
+    struct Result {
+        std::string step{};
+        std::size_t frames{};
+        TimeUtils::FPMilliseconds update_time{};
+        TimeUtils::FPMilliseconds record_time{};
+        RenderRecorder::Stats render_stats{};
+    };
+
+    static constexpr float frame_seconds = 1.0f / 60.0f;
+
+    ScriptedFrameRunner() = default;
+    ScriptedFrameRunner(const ScriptedFrameRunner& other) = default;
+    ScriptedFrameRunner(ScriptedFrameRunner&& other) = default;
+    ScriptedFrameRunner& operator=(const ScriptedFrameRunner& other) = default;
+    ScriptedFrameRunner& operator=(ScriptedFrameRunner&& other) = default;
+    ~ScriptedFrameRunner() = default;
+
+    bool LoadScript(const std::filesystem::path& src) noexcept;
+    bool ParseScript(const std::string& script) noexcept;
+    void Run(Map& map) noexcept;
+
+    const std::vector<Result>& GetResults() const noexcept;
+    void LogResults() const noexcept;
+
+protected:
+private:
+    struct Step {
+        std::string text{};
+        std::string command{};
+        std::string direction{};
+        std::size_t frames{};
+    };
+
+    void RunStep(Map& map, const Step& step) noexcept;
+    void ApplyPlayerAction(Map& map, const Step& step) noexcept;
+
+    std::vector<Step> _steps{};
+    std::vector<Result> _results{};
+};
@@ -17,6 +17,8 @@
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 
+static_assert(Tile::invalid_definition_id == TileDefinition::invalid_definition_id, "Tiles without a definition must use the definition sentinel");
+
 void Tile::ClearLightDirty() noexcept {
     _flags_coords_lightvalue &= ~tile_flags_dirty_light_mask;
 }
@@ -36,11 +38,17 @@ void Tile::DirtyLight() noexcept {
 
 void Tile::ClearOpaque() noexcept {
     _flags_coords_lightvalue &= ~tile_flags_opaque_mask;
+    if(layer) {
+        layer->UpdateOpacityAt(GetCoords());
+    }
 }
 
 void Tile::SetOpaque() noexcept {
     _flags_coords_lightvalue &= ~tile_flags_opaque_mask;
     _flags_coords_lightvalue |= tile_flags_opaque_mask;
+    if(layer) {
+        layer->UpdateOpacityAt(GetCoords());
+    }
 }
 
 void Tile::ClearSolid() noexcept {
@@ -52,21 +60,6 @@ void Tile::SetSolid() noexcept {
     _flags_coords_lightvalue |= tile_flags_solid_mask;
 }
 
-void Tile::Update(TimeUtils::FPSeconds deltaSeconds) {
-    if(auto* def = TileDefinition::GetTileDefinitionByName(_type)) {
-        def->GetSprite()->Update(deltaSeconds);
-        if(feature) {
-            feature->Update(deltaSeconds);
-        }
-        if(actor) {
-            actor->Update(deltaSeconds);
-        }
-        if(HasInventory() && inventory->size() == 1) {
-            inventory->GetItem(0)->GetSprite()->Update(deltaSeconds);
-        }
-    }
-}
-
 void Tile::DebugRender() const {
 #ifdef UI_DEBUG
     Entity* entity = (actor ? dynamic_cast<Entity*>(actor) : (feature ? dynamic_cast<Entity*>(feature) : nullptr));
@@ -90,30 +83,54 @@ void Tile::ChangeTypeFromName(const std::string& name) {
     _flags_coords_lightvalue &= ~tile_flags_opaque_solid_mask;
     _flags_coords_lightvalue |= def->GetLightingBits();
     _type = name;
-    layer->DirtyMesh();
+    _definition_id = def->GetDefinitionId();
+    OnTypeChanged();
 }
 
 void Tile::ChangeTypeFromGlyph(char glyph) {
-    if(const auto* my_def = TileDefinition::GetTileDefinitionByName(_type); my_def && my_def->glyph == glyph) {
+    if(const auto* my_def = GetDefinition(); my_def && my_def->glyph == glyph) {
         return;
     }
     if(const auto* new_def = TileDefinition::GetTileDefinitionByGlyph(glyph)) {
         _type = new_def->name;
+        _definition_id = new_def->GetDefinitionId();
         _flags_coords_lightvalue &= ~tile_flags_opaque_solid_mask;
         _flags_coords_lightvalue |= new_def->GetLightingBits();
-        layer->DirtyMesh();
+        OnTypeChanged();
     }
 }
 
 void Tile::ChangeTypeFromId(std::size_t id) {
-    if(const auto* my_def = TileDefinition::GetTileDefinitionByName(_type); my_def && my_def->GetIndex() == id) {
+    if(const auto* my_def = GetDefinition(); my_def && my_def->GetIndex() == id) {
         return;
     }
     if(const auto* new_def = TileDefinition::GetTileDefinitionByIndex(id)) {
         _type = new_def->name;
+        _definition_id = new_def->GetDefinitionId();
         _flags_coords_lightvalue &= ~tile_flags_opaque_solid_mask;
         _flags_coords_lightvalue |= new_def->GetLightingBits();
-        layer->DirtyMesh();
+        OnTypeChanged();
+    }
+}
+
+//Tiles created without a type change still carry the default type name.
+void Tile::ResolveDefinition() noexcept {
+    if(const auto* def = TileDefinition::GetTileDefinitionByName(_type)) {
+        _definition_id = def->GetDefinitionId();
+    }
+}
+
+void Tile::OnTypeChanged() noexcept {
+    //Neighboring quads share corner light with this tile, so dirty every chunk the 3x3 neighborhood touches.
+    const auto coords = GetCoords();
+    layer->DirtyMeshAt(coords + IntVector2{-1, -1});
+    layer->DirtyMeshAt(coords + IntVector2{1, -1});
+    layer->DirtyMeshAt(coords + IntVector2{-1, 1});
+    layer->DirtyMeshAt(coords + IntVector2{1, 1});
+    layer->DirtyStaticLight();
+    layer->UpdateOpacityAt(coords);
+    if(auto* map = layer->GetMap()) {
+        map->UpdateSkyLightColumn(*this);
     }
 }
 
@@ -122,7 +139,7 @@ AABB2 Tile::GetBounds() const {
 }
 
 bool Tile::IsVisible() const {
-    if(const auto* def = TileDefinition::GetTileDefinitionByName(_type)) {
+    if(const auto* def = GetDefinition()) {
         return def->is_visible;
     }
     return false;
@@ -137,11 +154,11 @@ bool Tile::IsInvisible() const {
 }
 
 bool Tile::CanSee() const noexcept {
-    return (_flags_coords_lightvalue & tile_flags_can_see_mask) == tile_flags_can_see_mask;
+    return layer && layer->IsTileVisible(GetIndexFromCoords());
 }
 
 bool Tile::HaveSeen() const noexcept {
-    return (_flags_coords_lightvalue & tile_flags_have_seen_mask) == tile_flags_have_seen_mask;
+    return layer && layer->IsTileExplored(GetIndexFromCoords());
 }
 
 bool Tile::IsLightDirty() const {
@@ -172,38 +189,38 @@ bool Tile::IsOpaqueOrSolid() const noexcept {
 }
 
 void Tile::SetEntrance() noexcept {
-    if(auto* def = TileDefinition::GetTileDefinitionByName(_type)) {
+    if(auto* def = GetDefinition()) {
         def->is_entrance = true;
     }
 }
 
 void Tile::SetExit() noexcept {
-    if(auto* def = TileDefinition::GetTileDefinitionByName(_type)) {
+    if(auto* def = GetDefinition()) {
         def->is_exit = true;
     }
 }
 
 void Tile::ClearEntrance() noexcept {
-    if(auto* def = TileDefinition::GetTileDefinitionByName(_type)) {
+    if(auto* def = GetDefinition()) {
         def->is_entrance = false;
     }
 }
 
 void Tile::ClearExit() noexcept {
-    if(auto* def = TileDefinition::GetTileDefinitionByName(_type)) {
+    if(auto* def = GetDefinition()) {
         def->is_exit = false;
     }
 }
 
 bool Tile::IsEntrance() const {
-    if(auto* def = TileDefinition::GetTileDefinitionByName(_type)) {
+    if(auto* def = GetDefinition()) {
         return def->is_entrance;
     }
     return false;
 }
 
 bool Tile::IsExit() const {
-    if(auto* def = TileDefinition::GetTileDefinitionByName(_type)) {
+    if(auto* def = GetDefinition()) {
         return def->is_exit;
     }
     return false;
@@ -285,21 +302,27 @@ void Tile::DecrementLightValue(int value /*= 1*/) noexcept {
 }
 
 void Tile::ClearCanSee() noexcept {
-    _flags_coords_lightvalue &= ~tile_flags_can_see_mask;
+    if(layer) {
+        layer->ClearTileVisible(GetIndexFromCoords());
+    }
 }
 
 void Tile::SetCanSee() noexcept {
-    _flags_coords_lightvalue &= ~tile_flags_can_see_mask;
-    _flags_coords_lightvalue |= tile_flags_can_see_mask;
+    if(layer) {
+        layer->SetTileVisible(GetIndexFromCoords());
+    }
 }
 
 void Tile::ClearHaveSeen() noexcept {
-    _flags_coords_lightvalue &= ~tile_flags_have_seen_mask;
+    if(layer) {
+        layer->ClearTileExplored(GetIndexFromCoords());
+    }
 }
 
 void Tile::SetHaveSeen() noexcept {
-    _flags_coords_lightvalue &= ~tile_flags_have_seen_mask;
-    _flags_coords_lightvalue |= tile_flags_have_seen_mask;
+    if(layer) {
+        layer->SetTileExplored(GetIndexFromCoords());
+    }
 }
 
 void Tile::ClearSky() noexcept {
@@ -474,14 +497,26 @@ void Tile::SetEntity(Entity* e) noexcept {
     }
     if(auto* asFeature = dynamic_cast<Feature*>(e)) {
         feature = asFeature;
+        layer->UpdateOpacityAt(GetCoords());
     }
-    layer->DirtyMesh();
 }
 
 const std::string Tile::GetType() const noexcept {
     return _type;
 }
 
+std::size_t Tile::GetDefinitionId() const noexcept {
+    return _definition_id;
+}
+
+const TileDefinition* Tile::GetDefinition() const noexcept {
+    return TileDefinition::GetTileDefinitionById(_definition_id);
+}
+
+TileDefinition* Tile::GetDefinition() noexcept {
+    return TileDefinition::GetTileDefinitionById(_definition_id);
+}
+
 bool TileInfo::IsLightDirty() const noexcept {
     if(layer == nullptr) {
         return false;
@@ -771,10 +806,15 @@ void TileInfo::SetLightValue(uint32_t newValue) noexcept {
     if(layer == nullptr) {
         return;
     }
-    if(auto* t = layer->GetTile(index); t != nullptr) {
+    if(auto* t = layer->GetTile(index); t != nullptr && t->GetLightValue() != newValue) {
         t->SetLightValue(newValue);
+        //Quad corners sample the neighboring tiles, so dirty every chunk the 3x3 neighborhood touches.
+        const auto coords = t->GetCoords();
+        layer->DirtyMeshAt(coords + IntVector2{-1, -1});
+        layer->DirtyMeshAt(coords + IntVector2{1, -1});
+        layer->DirtyMeshAt(coords + IntVector2{-1, 1});
+        layer->DirtyMeshAt(coords + IntVector2{1, 1});
     }
-    layer->DirtyMesh();
 }
 
 uint32_t TileInfo::GetSelfIlluminationValue() const noexcept {
@@ -782,13 +822,20 @@ uint32_t TileInfo::GetSelfIlluminationValue() const noexcept {
         return uint32_t{0u};
     }
     if(auto* tile = layer->GetTile(index); tile != nullptr) {
-        if(const auto* def = TileDefinition::GetTileDefinitionByName(tile->GetType()); def != nullptr) {
+        if(const auto* def = tile->GetDefinition(); def != nullptr) {
             return def->light;
         }
     }
     return uint32_t{0u};
 }
 
+uint32_t TileInfo::GetStaticLightValue() const noexcept {
+    if(layer == nullptr) {
+        return uint32_t{0u};
+    }
+    return layer->GetStaticLightValue(index);
+}
+
 uint32_t TileInfo::GetMaxLightValueFromNeighbors() const noexcept {
     if(layer == nullptr) {
         return 0;
@@ -831,7 +878,7 @@ bool TileInfo::IsSky() const noexcept {
         return false;
     }
     if(auto* tile = layer->GetTile(index); tile != nullptr) {
-        return tile->GetType() == "void";
+        return tile->IsSky();
     }
     return false;
 }
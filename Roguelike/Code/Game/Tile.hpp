@@ -22,6 +22,8 @@ class Layer;
 
 class Tile {
 public:
+    static constexpr std::size_t invalid_definition_id = static_cast<std::size_t>(-1);
+
     Tile() = default;
     Tile(const Tile& other) = default;
     Tile(Tile&& other) = default;
@@ -29,13 +31,12 @@ public:
     Tile& operator=(Tile&& other) = default;
     ~Tile() = default;
 
-    void Update(TimeUtils::FPSeconds deltaSeconds);
-
     void DebugRender() const;
 
     void ChangeTypeFromName(const std::string& name);
     void ChangeTypeFromGlyph(char glyph);
     void ChangeTypeFromId(std::size_t id);
+    void ResolveDefinition() noexcept;
 
     AABB2 GetBounds() const;
 
@@ -132,6 +133,9 @@ public:
     Entity* GetEntity() const noexcept;
     void SetEntity(Entity* e) noexcept;
     const std::string GetType() const noexcept;
+    std::size_t GetDefinitionId() const noexcept;
+    const TileDefinition* GetDefinition() const noexcept;
+    TileDefinition* GetDefinition() noexcept;
 
     Rgba debugRaycastColor = Rgba::Red;
     Rgba highlightColor = Rgba::White;
@@ -142,7 +146,10 @@ public:
     std::unique_ptr<Inventory> inventory{};
 protected:
 private:
+    void OnTypeChanged() noexcept;
+
     std::string _type{"void"};
+    std::size_t _definition_id{invalid_definition_id};
     uint32_t _flags_coords_lightvalue{};
 };
 
@@ -208,6 +215,7 @@ public:
     uint32_t GetLightValue() const noexcept;
     void SetLightValue(uint32_t newValue) noexcept;
     uint32_t GetSelfIlluminationValue() const noexcept;
+    uint32_t GetStaticLightValue() const noexcept;
     uint32_t GetMaxLightValueFromNeighbors() const noexcept;
 
 protected:
@@ -22,6 +22,7 @@ TileDefinition* TileDefinition::CreateOrGetTileDefinition(const XMLElement& elem
         return new_def_ptr;
     } else {
         s_registry.try_emplace(new_def_name, std::move(new_def));
+        AssignDefinitionId(new_def_ptr);
     }
     return new_def_ptr;
 }
@@ -30,12 +31,21 @@ TileDefinition* TileDefinition::CreateTileDefinition(const XMLElement& elem, std
     auto new_def = std::make_unique<TileDefinition>(elem, sheet);
     auto* new_def_ptr = new_def.get();
     std::string new_def_name = new_def->name;
-    s_registry.try_emplace(new_def_name, std::move(new_def));
+    if(s_registry.try_emplace(new_def_name, std::move(new_def)).second) {
+        AssignDefinitionId(new_def_ptr);
+    }
     return new_def_ptr;
 }
 
 void TileDefinition::ClearTileDefinitions() {
     s_registry.clear();
+    s_definitions_by_id.clear();
+}
+
+//Ids are dense and assigned in registration order, so per-definition tables can be plain vectors.
+void TileDefinition::AssignDefinitionId(TileDefinition* def) noexcept {
+    def->_definition_id = s_definitions_by_id.size();
+    s_definitions_by_id.push_back(def);
 }
 
 TileDefinition* TileDefinition::GetTileDefinitionByName(const std::string& name) {
@@ -64,6 +74,29 @@ TileDefinition* TileDefinition::GetTileDefinitionByIndex(std::size_t index) {
     return nullptr;
 }
 
+TileDefinition* TileDefinition::GetTileDefinitionById(std::size_t definition_id) noexcept {
+    if(definition_id < s_definitions_by_id.size()) {
+        return s_definitions_by_id[definition_id];
+    }
+    return nullptr;
+}
+
+std::size_t TileDefinition::GetTileDefinitionIdByName(const std::string& name) noexcept {
+    if(const auto* def = GetTileDefinitionByName(name); def != nullptr) {
+        return def->GetDefinitionId();
+    }
+    return invalid_definition_id;
+}
+
+std::vector<TileDefinition*> TileDefinition::GetAllTileDefinitions() {
+    std::vector<TileDefinition*> result{};
+    result.reserve(s_registry.size());
+    for(const auto& tile : s_registry) {
+        result.push_back(tile.second.get());
+    }
+    return result;
+}
+
 uint32_t TileDefinition::GetLightingBits() const noexcept {
     if(is_opaque && is_solid) {
         return tile_flags_opaque_mask | tile_flags_solid_mask;
@@ -203,3 +236,7 @@ void TileDefinition::AddOffsetToIndex(std::size_t offset) {
     const auto y = static_cast<int>(_index.y);
     SetIndex(x, y);
 }
+
+std::size_t TileDefinition::GetDefinitionId() const noexcept {
+    return _definition_id;
+}
@@ -6,6 +6,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 
 class AnimatedSprite;
@@ -34,6 +35,8 @@ struct TileDefinitionDesc {
 
 class TileDefinition {
 public:
+    static constexpr std::size_t invalid_definition_id = static_cast<std::size_t>(-1);
+
     TileDefinition() = delete;
     TileDefinition(const TileDefinition& other) = default;
     TileDefinition(TileDefinition&& other) = default;
@@ -48,6 +51,9 @@ public:
     static TileDefinition* GetTileDefinitionByName(const std::string& name);
     static TileDefinition* GetTileDefinitionByGlyph(char glyph);
     static TileDefinition* GetTileDefinitionByIndex(std::size_t index);
+    static TileDefinition* GetTileDefinitionById(std::size_t definition_id) noexcept;
+    static std::size_t GetTileDefinitionIdByName(const std::string& name) noexcept;
+    static std::vector<TileDefinition*> GetAllTileDefinitions();
 
     bool is_opaque = false;
     bool is_visible = true;
@@ -72,6 +78,7 @@ public:
     AnimatedSprite* GetSprite();
     IntVector2 GetIndexCoords() const;
     std::size_t GetIndex() const;
+    std::size_t GetDefinitionId() const noexcept;
 
     TileDefinition(const XMLElement& elem, std::shared_ptr<SpriteSheet> sheet);
 protected:
@@ -81,11 +88,14 @@ private:
     void SetIndex(int x, int y);
     void SetIndex(const IntVector2& indexCoords);
     void AddOffsetToIndex(std::size_t offset);
+    static void AssignDefinitionId(TileDefinition* def) noexcept;
 
     static inline std::map<std::string, std::unique_ptr<TileDefinition>> s_registry{};
+    static inline std::vector<TileDefinition*> s_definitions_by_id{};
     std::shared_ptr<SpriteSheet> _sheet{};
     std::unique_ptr<AnimatedSprite> _sprite{};
     IntVector2 _index{};
     std::size_t _random_index_offset = 0u;
+    std::size_t _definition_id{invalid_definition_id};
 
 };
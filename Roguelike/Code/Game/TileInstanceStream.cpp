@@ -0,0 +1,61 @@
+#include "Game/TileInstanceStream.hpp"
+
+#include "Engine/Renderer/Vertex3D.hpp"
+
+#include "Game/GameCommon.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+//The sprite cell is recovered from the texture coordinates, which are always one whole cell of the sheet.
+TileInstance TileInstanceStream::MakeInstance(const IntVector2& tile_coords, const AABB2& uv_coords, const std::array<uint32_t, 4>& corner_lights) noexcept {
+    const auto cell_width = uv_coords.maxs.x - uv_coords.mins.x;
+    const auto cell_height = uv_coords.maxs.y - uv_coords.mins.y;
+    const auto sprite_x = cell_width > 0.0f ? std::lround(uv_coords.mins.x / cell_width) : 0l;
+    const auto sprite_y = cell_height > 0.0f ? std::lround(uv_coords.mins.y / cell_height) : 0l;
+    return TileInstance{
+        static_cast<uint16_t>(tile_coords.x)
+        , static_cast<uint16_t>(tile_coords.y)
+        , static_cast<uint8_t>(sprite_x)
+        , static_cast<uint8_t>(sprite_y)
+        , PackCornerLights(corner_lights)
+    };
+}
+
+uint16_t TileInstanceStream::PackCornerLights(const std::array<uint32_t, 4>& corner_lights) noexcept {
+    uint16_t packed{0u};
+    for(auto corner = std::size_t{0u}; corner != corner_lights.size(); ++corner) {
+        const auto light_value = (std::min)(corner_lights[corner], static_cast<uint32_t>(max_light_value));
+        packed |= static_cast<uint16_t>(light_value << (corner * 4u));
+    }
+    return packed;
+}
+
+//What the same tiles cost as expanded quads: four vertices and six indices each.
+std::size_t TileInstanceStream::GetExpandedByteSize(std::size_t tile_count) noexcept {
+    return tile_count * (4u * sizeof(Vertex3D) + 6u * sizeof(unsigned int));
+}
+
+void TileInstanceStream::Append(const IntVector2& tile_coords, const AABB2& uv_coords, const std::array<uint32_t, 4>& corner_lights) noexcept {
+    _instances.push_back(MakeInstance(tile_coords, uv_coords, corner_lights));
+}
+
+void TileInstanceStream::Clear() noexcept {
+    _instances.clear();
+}
+
+std::span<const TileInstance> TileInstanceStream::GetInstances() const noexcept {
+    return _instances;
+}
+
+std::size_t TileInstanceStream::size() const noexcept {
+    return _instances.size();
+}
+
+bool TileInstanceStream::empty() const noexcept {
+    return _instances.empty();
+}
+
+std::size_t TileInstanceStream::GetByteSize() const noexcept {
+    return _instances.size() * sizeof(TileInstance);
+}
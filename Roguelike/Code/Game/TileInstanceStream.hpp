@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/IntVector2.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//One terrain tile in a compact 8-byte instance format.
+//Tile coordinates, the sprite cell in the sheet and four 4-bit corner light values
+//replace the four Vertex3D and six indices of an expanded quad.
+//CPU side only: nothing draws it until the renderer has an instanced draw path.
+struct TileInstance {
+    uint16_t x{};
+    uint16_t y{};
+    uint8_t sprite_x{};
+    uint8_t sprite_y{};
+    uint16_t corner_lights{};
+};
+static_assert(sizeof(TileInstance) == 8u, "TileInstance must stay two 32-bit words");
+
+class TileInstanceStream {
+public:
+    //Corner lights are in bottom-left, top-left, top-right, bottom-right order.
+    static TileInstance MakeInstance(const IntVector2& tile_coords, const AABB2& uv_coords, const std::array<uint32_t, 4>& corner_lights) noexcept;
+    static uint16_t PackCornerLights(const std::array<uint32_t, 4>& corner_lights) noexcept;
+    static std::size_t GetExpandedByteSize(std::size_t tile_count) noexcept;
+
+    void Append(const IntVector2& tile_coords, const AABB2& uv_coords, const std::array<uint32_t, 4>& corner_lights) noexcept;
+    void Clear() noexcept;
+
+    std::span<const TileInstance> GetInstances() const noexcept;
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+    std::size_t GetByteSize() const noexcept;
+
+protected:
+private:
+    std::vector<TileInstance> _instances{};
+};
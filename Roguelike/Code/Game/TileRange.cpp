@@ -0,0 +1,118 @@
+#include "Game/TileRange.hpp"
+
+#include "Game/Layer.hpp"
+#include "Game/Tile.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+TileRange::TileRange(Layer* layer, const IntVector2& center, float radius, TileDistanceMetric metric) noexcept
+    : _layer(layer)
+    , _center(center)
+    , _radius(radius)
+    , _extent(static_cast<int>(std::ceil((std::max)(radius, 0.0f))))
+    , _metric(metric)
+{
+    const auto integral_radius = static_cast<int>(radius);
+    if(radius >= 0.0f && static_cast<float>(integral_radius) == radius && integral_radius <= TileOffsets::max_table_radius) {
+        _use_table = true;
+        _table = _metric == TileDistanceMetric::Manhattan ? TileOffsets::tables<TileDistanceMetric::Manhattan>[integral_radius] : TileOffsets::tables<TileDistanceMetric::Euclidean>[integral_radius];
+    }
+}
+
+TileRange::iterator TileRange::begin() const noexcept {
+    return iterator{this, false};
+}
+
+TileRange::iterator TileRange::end() const noexcept {
+    return iterator{this, true};
+}
+
+bool TileRange::empty() const noexcept {
+    return begin() == end();
+}
+
+bool TileRange::IsWithin(const IntVector2& offset) const noexcept {
+    if(_metric == TileDistanceMetric::Manhattan) {
+        return static_cast<float>(std::abs(offset.x) + std::abs(offset.y)) < _radius;
+    }
+    return static_cast<float>(offset.x * offset.x + offset.y * offset.y) < _radius * _radius;
+}
+
+TileRange::iterator::iterator(const TileRange* range, bool is_end) noexcept
+    : _range(range)
+{
+    if(is_end || _range->_layer == nullptr || _range->_radius <= 0.0f) {
+        return;
+    }
+    if(_range->_use_table) {
+        if(_range->_table.empty()) {
+            return;
+        }
+        _offset = IntVector2{_range->_table.front().x, _range->_table.front().y};
+    } else {
+        _offset = IntVector2{-_range->_extent, -_range->_extent};
+    }
+    if(IsCandidate()) {
+        _tile = _range->_layer->GetTile(static_cast<std::size_t>(_range->_center.x + _offset.x), static_cast<std::size_t>(_range->_center.y + _offset.y));
+    } else {
+        Advance();
+    }
+}
+
+Tile* TileRange::iterator::operator*() const noexcept {
+    return _tile;
+}
+
+TileRange::iterator& TileRange::iterator::operator++() noexcept {
+    Advance();
+    return *this;
+}
+
+TileRange::iterator TileRange::iterator::operator++(int) noexcept {
+    auto result = *this;
+    Advance();
+    return result;
+}
+
+bool TileRange::iterator::operator==(const iterator& other) const noexcept {
+    return _tile == other._tile;
+}
+
+bool TileRange::iterator::operator!=(const iterator& other) const noexcept {
+    return !(*this == other);
+}
+
+bool TileRange::iterator::IsCandidate() const noexcept {
+    //Table offsets are within the radius by construction.
+    if(!_range->_use_table && !_range->IsWithin(_offset)) {
+        return false;
+    }
+    const auto x = _range->_center.x + _offset.x;
+    const auto y = _range->_center.y + _offset.y;
+    return !(x < 0 || y < 0 || x >= _range->_layer->tileDimensions.x || y >= _range->_layer->tileDimensions.y);
+}
+
+void TileRange::iterator::Advance() noexcept {
+    _tile = nullptr;
+    while(true) {
+        if(_range->_use_table) {
+            if(++_offset_index >= _range->_table.size()) {
+                return;
+            }
+            const auto& entry = _range->_table[_offset_index];
+            _offset = IntVector2{entry.x, entry.y};
+        } else {
+            if(++_offset.x > _range->_extent) {
+                _offset.x = -_range->_extent;
+                if(++_offset.y > _range->_extent) {
+                    return;
+                }
+            }
+        }
+        if(IsCandidate()) {
+            _tile = _range->_layer->GetTile(static_cast<std::size_t>(_range->_center.x + _offset.x), static_cast<std::size_t>(_range->_center.y + _offset.y));
+            return;
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Engine/Math/IntVector2.hpp"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <utility>
+
+class Layer;
+class Tile;
+
+enum class TileDistanceMetric {
+    Manhattan
+    ,Euclidean
+};
+
+namespace TileOffsets {
+
+struct Offset {
+    int x{};
+    int y{};
+};
+
+constexpr int max_table_radius = 8;
+
+template<TileDistanceMetric Metric>
+constexpr bool IsWithin(int dx, int dy, int radius) noexcept {
+    if constexpr(Metric == TileDistanceMetric::Manhattan) {
+        return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy) < radius;
+    } else {
+        return dx * dx + dy * dy < radius * radius;
+    }
+}
+
+template<TileDistanceMetric Metric, int Radius>
+constexpr std::size_t CountOffsets() noexcept {
+    std::size_t count{0u};
+    for(int dy = -Radius; dy <= Radius; ++dy) {
+        for(int dx = -Radius; dx <= Radius; ++dx) {
+            count += IsWithin<Metric>(dx, dy, Radius) ? 1u : 0u;
+        }
+    }
+    return count;
+}
+
+//Row-major order, so walking a table touches tiles in memory order.
+template<TileDistanceMetric Metric, int Radius>
+constexpr auto MakeOffsets() noexcept {
+    std::array<Offset, CountOffsets<Metric, Radius>()> offsets{};
+    std::size_t i{0u};
+    for(int dy = -Radius; dy <= Radius; ++dy) {
+        for(int dx = -Radius; dx <= Radius; ++dx) {
+            if(IsWithin<Metric>(dx, dy, Radius)) {
+                offsets[i++] = Offset{dx, dy};
+            }
+        }
+    }
+    return offsets;
+}
+
+template<TileDistanceMetric Metric, int Radius>
+inline constexpr auto offsets = MakeOffsets<Metric, Radius>();
+
+template<TileDistanceMetric Metric, std::size_t... Radii>
+constexpr auto MakeTables(std::index_sequence<Radii...>) noexcept {
+    return std::array<std::span<const Offset>, sizeof...(Radii)>{std::span<const Offset>{offsets<Metric, static_cast<int>(Radii)>}...};
+}
+
+template<TileDistanceMetric Metric>
+inline constexpr auto tables = MakeTables<Metric>(std::make_index_sequence<max_table_radius + 1>{});
+
+} // namespace TileOffsets
+
+//A lazily evaluated view of the tiles of a layer strictly closer than a radius to a center.
+//Integral radii up to TileOffsets::max_table_radius walk a precomputed offset table;
+//anything larger walks the bounding box of the radius. Either way the cost is O(r^2).
+class TileRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Tile*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Tile**;
+        using reference = Tile*;
+
+        iterator() = default;
+        iterator(const TileRange* range, bool is_end) noexcept;
+
+        Tile* operator*() const noexcept;
+        iterator& operator++() noexcept;
+        iterator operator++(int) noexcept;
+        bool operator==(const iterator& other) const noexcept;
+        bool operator!=(const iterator& other) const noexcept;
+
+    private:
+        void Advance() noexcept;
+        bool IsCandidate() const noexcept;
+
+        const TileRange* _range{};
+        std::size_t _offset_index{};
+        IntVector2 _offset{};
+        Tile* _tile{};
+    };
+
+    TileRange() = default;
+    TileRange(Layer* layer, const IntVector2& center, float radius, TileDistanceMetric metric) noexcept;
+
+    iterator begin() const noexcept;
+    iterator end() const noexcept;
+    bool empty() const noexcept;
+
+protected:
+private:
+    bool IsWithin(const IntVector2& offset) const noexcept;
+
+    Layer* _layer{};
+    IntVector2 _center{};
+    float _radius{};
+    int _extent{};
+    TileDistanceMetric _metric{TileDistanceMetric::Euclidean};
+    std::span<const TileOffsets::Offset> _table{};
+    bool _use_table{false};
+};
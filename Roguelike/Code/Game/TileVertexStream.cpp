@@ -0,0 +1,71 @@
+#include "Game/TileVertexStream.hpp"
+
+#include "Engine/Renderer/Vertex3D.hpp"
+
+#include <emmintrin.h>
+
+static_assert(sizeof(Rgba) == 4u, "PackQuad loads the four corner colors as one 128-bit vector");
+
+//All four corners are converted at once, one per lane, then interleaved into the three
+//128-bit stores that make up the quad's 48 bytes.
+void TileVertexStream::PackQuad(std::span<TileVertex, vertices_per_quad> out, const IntVector2& tile_coords, const AABB2& uv_coords, const std::array<Rgba, 4>& corner_colors) noexcept {
+    const __m128i x4 = _mm_add_epi32(_mm_set1_epi32(tile_coords.x), _mm_setr_epi32(0, 0, 1, 1));
+    const __m128i y4 = _mm_add_epi32(_mm_set1_epi32(tile_coords.y), _mm_setr_epi32(1, 0, 0, 1));
+    const __m128i xy4 = _mm_or_si128(_mm_and_si128(x4, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(y4, 16));
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 unorm16_scale = _mm_set1_ps(65535.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 u4 = _mm_setr_ps(uv_coords.mins.x, uv_coords.mins.x, uv_coords.maxs.x, uv_coords.maxs.x);
+    const __m128 v4 = _mm_setr_ps(uv_coords.maxs.y, uv_coords.mins.y, uv_coords.mins.y, uv_coords.maxs.y);
+    const __m128i u16 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(u4, zero), one), unorm16_scale), half));
+    const __m128i v16 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(v4, zero), one), unorm16_scale), half));
+    const __m128i uv4 = _mm_or_si128(u16, _mm_slli_epi32(v16, 16));
+
+    const __m128i color4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(corner_colors.data()));
+
+    //lo: xy0 uv0 xy1 uv1, hi: xy2 uv2 xy3 uv3, mid: c0 xy1 c1 uv1
+    const __m128i lo = _mm_unpacklo_epi32(xy4, uv4);
+    const __m128i hi = _mm_unpackhi_epi32(xy4, uv4);
+    const __m128i mid = _mm_unpacklo_epi32(color4, _mm_srli_si128(lo, 8));
+    const __m128 first = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(mid), _MM_SHUFFLE(1, 0, 1, 0));
+    const __m128 second = _mm_shuffle_ps(_mm_castsi128_ps(mid), _mm_castsi128_ps(hi), _MM_SHUFFLE(1, 0, 2, 3));
+    const __m128i last = _mm_shuffle_epi32(_mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(color4), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 2, 3, 2))), _MM_SHUFFLE(1, 3, 2, 0));
+
+    auto* dest = reinterpret_cast<__m128i*>(out.data());
+    _mm_storeu_si128(dest + 0, _mm_castps_si128(first));
+    _mm_storeu_si128(dest + 1, _mm_castps_si128(second));
+    _mm_storeu_si128(dest + 2, last);
+}
+
+//What the same quads cost as Vertex3D corners.
+std::size_t TileVertexStream::GetExpandedByteSize(std::size_t quad_count) noexcept {
+    return quad_count * vertices_per_quad * sizeof(Vertex3D);
+}
+
+void TileVertexStream::AppendQuad(const IntVector2& tile_coords, const AABB2& uv_coords, const std::array<Rgba, 4>& corner_colors) noexcept {
+    const auto first = _vertices.size();
+    _vertices.resize(first + vertices_per_quad);
+    PackQuad(std::span<TileVertex, vertices_per_quad>{_vertices.data() + first, vertices_per_quad}, tile_coords, uv_coords, corner_colors);
+}
+
+void TileVertexStream::Clear() noexcept {
+    _vertices.clear();
+}
+
+std::span<const TileVertex> TileVertexStream::GetVertices() const noexcept {
+    return _vertices;
+}
+
+std::size_t TileVertexStream::GetQuadCount() const noexcept {
+    return _vertices.size() / vertices_per_quad;
+}
+
+bool TileVertexStream::empty() const noexcept {
+    return _vertices.empty();
+}
+
+std::size_t TileVertexStream::GetByteSize() const noexcept {
+    return _vertices.size() * sizeof(TileVertex);
+}
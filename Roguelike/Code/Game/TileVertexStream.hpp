@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Engine/Core/Rgba.hpp"
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/IntVector2.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//One terrain quad corner in a compact layout. Nothing binds it to a draw until the renderer
+//has an input layout for it; Layer still draws terrain as Vertex3D quads.
+//Positions are whole tile coordinates, texture coordinates are unorm16 fractions of the sheet
+//and the color is the corner's light color as unorm8. The normal is implied by the tile plane.
+struct TileVertex {
+    int16_t x{};
+    int16_t y{};
+    uint16_t u{};
+    uint16_t v{};
+    Rgba color{};
+};
+static_assert(sizeof(TileVertex) == 12u, "TileVertex is expected to pack into 12 bytes");
+
+class TileVertexStream {
+public:
+    static constexpr std::size_t vertices_per_quad = 4u;
+
+    //Corners are in bottom-left, top-left, top-right, bottom-right order, the same as Layer's Vertex3D quads.
+    static void PackQuad(std::span<TileVertex, vertices_per_quad> out, const IntVector2& tile_coords, const AABB2& uv_coords, const std::array<Rgba, 4>& corner_colors) noexcept;
+    static std::size_t GetExpandedByteSize(std::size_t quad_count) noexcept;
+
+    void AppendQuad(const IntVector2& tile_coords, const AABB2& uv_coords, const std::array<Rgba, 4>& corner_colors) noexcept;
+    void Clear() noexcept;
+
+    std::span<const TileVertex> GetVertices() const noexcept;
+    std::size_t GetQuadCount() const noexcept;
+    bool empty() const noexcept;
+    std::size_t GetByteSize() const noexcept;
+
+protected:
+private:
+    std::vector<TileVertex> _vertices{};
+};